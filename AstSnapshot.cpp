@@ -0,0 +1,142 @@
+﻿#include "AstSnapshot.h"
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+    const char MAGIC[4] = { 'S', 'A', 'S', 'T' };
+
+    uint32_t alignUp(uint32_t offset, uint32_t alignment) {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    // Раздел [offset, offset + count * size) целиком внутри файла и выровнен под alignment
+    bool sectionFits(const char* base, size_t fileSize, uint32_t offset, uint64_t count, size_t size, size_t alignment) {
+        if (offset > fileSize || count * size > fileSize - offset) {
+            return false;
+        }
+        return reinterpret_cast<uintptr_t>(base + offset) % alignment == 0;
+    }
+
+}
+
+bool AstSnapshot::write(const FlatTree& tree, const std::string& fileName) {
+    // Символы Interner, которые встречаются в дереве, получают номера по порядку появления
+    std::vector<uint32_t> local(Interner::size(), FlatTree::NONE);
+    std::vector<Symbol> symbols;
+    std::string strings;
+    std::vector<Node> nodes;
+    nodes.reserve(tree.size());
+    for (uint32_t i = 0; i < tree.size(); ++i) {
+        const FlatTree::Node& node = tree[i];
+        uint32_t& symbol = local[node.symbol];
+        if (symbol == FlatTree::NONE) {
+            std::string_view text = Interner::text(node.symbol);
+            symbol = static_cast<uint32_t>(symbols.size());
+            symbols.push_back({ static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(text.size()) });
+            strings.append(text.data(), text.size());
+        }
+        nodes.push_back({ symbol, node.parent, node.end, node.depth, node.level, node.kind, {} });
+    }
+
+    // Смещения разделов и строк в формате 32-битные: дерево, которое в них не помещается,
+    // не записывается вовсе, а не обрезается
+    uint64_t nodesOffset = alignUp(sizeof(Header), 8);
+    uint64_t symbolsOffset = nodesOffset + uint64_t(nodes.size()) * sizeof(Node);
+    uint64_t stringsOffset = symbolsOffset + uint64_t(symbols.size()) * sizeof(Symbol);
+    if (stringsOffset > UINT32_MAX || strings.size() > UINT32_MAX) {
+        return false;
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.endianMark = ENDIAN_MARK;
+    header.nodeCount = static_cast<uint32_t>(nodes.size());
+    header.symbolCount = static_cast<uint32_t>(symbols.size());
+    header.stringsSize = static_cast<uint32_t>(strings.size());
+    header.nodesOffset = static_cast<uint32_t>(nodesOffset);
+    header.symbolsOffset = static_cast<uint32_t>(symbolsOffset);
+    header.stringsOffset = static_cast<uint32_t>(stringsOffset);
+
+    std::ofstream outFile(fileName, std::ios::binary);
+    if (!outFile.is_open()) {
+        return false;
+    }
+    outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    outFile.write(reinterpret_cast<const char*>(nodes.data()), nodes.size() * sizeof(Node));
+    outFile.write(reinterpret_cast<const char*>(symbols.data()), symbols.size() * sizeof(Symbol));
+    outFile.write(strings.data(), strings.size());
+    return static_cast<bool>(outFile);
+}
+
+bool AstSnapshot::open(const std::string& fileName) {
+    close();
+    if (!buffer.open(fileName)) {
+        return false;
+    }
+    const char* base = buffer.begin();
+    size_t fileSize = buffer.size();
+    if (!sectionFits(base, fileSize, 0, 1, sizeof(Header), alignof(Header))) {
+        buffer.close();
+        return false;
+    }
+    const Header* candidate = reinterpret_cast<const Header*>(base);
+    if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0 || candidate->version != VERSION
+        || candidate->endianMark != ENDIAN_MARK
+        || !sectionFits(base, fileSize, candidate->nodesOffset, candidate->nodeCount, sizeof(Node), alignof(Node))
+        || !sectionFits(base, fileSize, candidate->symbolsOffset, candidate->symbolCount, sizeof(Symbol), alignof(Symbol))
+        || !sectionFits(base, fileSize, candidate->stringsOffset, candidate->stringsSize, 1, 1)) {
+        buffer.close();
+        return false;
+    }
+    header = candidate;
+    nodes = reinterpret_cast<const Node*>(base + header->nodesOffset);
+    symbols = reinterpret_cast<const Symbol*>(base + header->symbolsOffset);
+    strings = base + header->stringsOffset;
+    if (!contentValid()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool AstSnapshot::contentValid() const {
+    // Один проход по узлам и символам: ссылки внутри файла и дерево в прямом порядке
+    for (uint32_t i = 0; i < header->symbolCount; ++i) {
+        if (uint64_t(symbols[i].offset) + symbols[i].length > header->stringsSize) {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < header->nodeCount; ++i) {
+        const Node& node = nodes[i];
+        if (node.symbol >= header->symbolCount || node.kind > NodeKind::CLOSING_BRACKET
+            || node.end <= i || node.end > header->nodeCount) {
+            return false;
+        }
+        bool root = node.parent == FlatTree::NONE;
+        if (root ? node.depth != 0 : node.parent >= i || node.depth != nodes[node.parent].depth + 1
+            || node.end > nodes[node.parent].end) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AstSnapshot::close() {
+    buffer.close();
+    header = nullptr;
+    nodes = nullptr;
+    symbols = nullptr;
+    strings = nullptr;
+}
+
+void AstSnapshot::printTree(std::ostream& outFile) const {
+    for (uint32_t i = 0; i < size(); ++i) {
+        const Node& node = nodes[i];
+        outFile << std::string(2 * node.depth, ' ') << getData(i);
+        if (node.kind != NodeKind::NONE) outFile << " [" << nodeKindName(node.kind) << "]";
+        outFile << '\n';
+    }
+}
@@ -0,0 +1,90 @@
+﻿#ifndef ASTSNAPSHOT_H
+#define ASTSNAPSHOT_H
+
+#include "FlatTree.h"
+#include "NodeKind.h"
+#include "SourceBuffer.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Дерево разбора в двоичном файле, который читается отображением в память без разбора узлов.
+// Файл: заголовок, массив узлов в прямом порядке (как в FlatTree), таблица символов
+// (смещение и длина строки) и сами строки подряд. Номера символов в файле свои, плотные,
+// и от Interner не зависят. Числа записаны в порядке байтов машины, которая писала файл:
+// open() отказывается от файла с другим порядком байтов или другой версией формата.
+class AstSnapshot {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_MARK = 0x01020304u;
+
+    struct Header {
+        char magic[4];         // "SAST"
+        uint32_t version;
+        uint32_t endianMark;    // ENDIAN_MARK в порядке байтов писавшей машины
+        uint32_t nodeCount;
+        uint32_t symbolCount;
+        uint32_t stringsSize;
+        uint32_t nodesOffset;  // от начала файла, кратно 8
+        uint32_t symbolsOffset;
+        uint32_t stringsOffset;
+        uint32_t reserved;
+    };
+
+    struct Node {
+        uint32_t symbol;       // номер в таблице символов файла
+        uint32_t parent;       // FlatTree::NONE у корня
+        uint32_t end;          // конец поддерева, как FlatTree::Node::end
+        uint32_t depth;        // 0 у корня
+        int32_t level;         // TreeNode::getLevel()
+        NodeKind kind;
+        uint8_t reserved[3];
+    };
+
+    struct Symbol {
+        uint32_t offset;       // от начала строк
+        uint32_t length;
+    };
+
+    static_assert(sizeof(Header) == 40, "snapshot header layout");
+    static_assert(sizeof(Node) == 24, "snapshot node layout");
+    static_assert(sizeof(Symbol) == 8, "snapshot symbol layout");
+
+    // false, если файл не удалось записать или дерево не помещается в 32-битные смещения формата
+    static bool write(const FlatTree& tree, const std::string& fileName);
+
+    AstSnapshot() {}
+    AstSnapshot(const AstSnapshot&) = delete;
+    AstSnapshot& operator=(const AstSnapshot&) = delete;
+
+    // false, если файла нет, это не снимок этой версии или он повреждён: кроме заголовка
+    // и границ разделов за один проход проверяются номера символов и типы узлов, строки
+    // символов внутри раздела строк и связи родитель - сын, так что обращения к узлам
+    // открытого снимка не выходят за файл.
+    bool open(const std::string& fileName);
+    void close();
+
+    bool isOpen() const { return header != nullptr; }
+    uint32_t size() const { return header ? header->nodeCount : 0; }
+    uint32_t symbolCount() const { return header ? header->symbolCount : 0; }
+    const Node& operator[](uint32_t i) const { return nodes[i]; }
+    std::string_view text(uint32_t symbol) const {
+        return std::string_view(strings + symbols[symbol].offset, symbols[symbol].length);
+    }
+    std::string_view getData(uint32_t i) const { return text(nodes[i].symbol); }
+
+    // Тот же текст, что Printing_Tree пишет в parsing_tree.txt
+    void printTree(std::ostream& outFile) const;
+
+private:
+    bool contentValid() const;
+
+    SourceBuffer buffer;
+    const Header* header = nullptr;
+    const Node* nodes = nullptr;
+    const Symbol* symbols = nullptr;
+    const char* strings = nullptr;
+};
+
+#endif // ASTSNAPSHOT_H
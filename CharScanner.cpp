@@ -0,0 +1,254 @@
+﻿#include "CharScanner.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CHARSCANNER_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(CHARSCANNER_X86) && defined(__GNUC__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+namespace {
+
+    enum RunKind { RUN_IDENT, RUN_LETTER, RUN_DIGIT, RUN_SPACE };
+
+    enum : uint8_t { F_LETTER = 1, F_DIGIT = 2, F_UNDER = 4, F_SPACE = 8 };
+
+    constexpr std::array<uint8_t, 256> makeFlags() {
+        std::array<uint8_t, 256> table{};
+        for (int c = 0; c < 256; ++c) {
+            if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) table[c] = F_LETTER;
+            else if (c >= '0' && c <= '9') table[c] = F_DIGIT;
+        }
+        table['_'] = F_UNDER;
+        table[' '] = F_SPACE;
+        table['\t'] = F_SPACE;
+        table['\v'] = F_SPACE;
+        table['\f'] = F_SPACE;
+        return table;
+    }
+
+    constexpr std::array<uint8_t, 256> flags = makeFlags();
+
+    constexpr uint8_t kindMask[] = { F_LETTER | F_DIGIT | F_UNDER, F_LETTER, F_DIGIT, F_SPACE };
+
+    inline bool matches(char c, int kind) {
+        return (flags[static_cast<unsigned char>(c)] & kindMask[kind]) != 0;
+    }
+
+    size_t runScalar(const char* p, const char* end, int kind) {
+        const char* start = p;
+        while (p != end && matches(*p, kind)) {
+            ++p;
+        }
+        return static_cast<size_t>(p - start);
+    }
+
+    void newlinesScalar(const char* begin, const char* p, const char* end, std::vector<uint32_t>& starts) {
+        while (const void* found = p != end ? std::memchr(p, '\n', static_cast<size_t>(end - p)) : nullptr) {
+            p = static_cast<const char*>(found) + 1;
+            starts.push_back(static_cast<uint32_t>(p - begin));
+        }
+    }
+
+#ifdef CHARSCANNER_X86
+
+    inline unsigned countTrailingZeros(uint32_t bits) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return index;
+#else
+        return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+    }
+
+    // Байты x из диапазона [lo, hi]: сдвигаем диапазон к -128 и сравниваем со знаком
+    TARGET_SSE2 inline __m128i inRange16(__m128i x, char lo, char hi) {
+        __m128i shifted = _mm_add_epi8(x, _mm_set1_epi8(static_cast<char>(0x80 - lo)));
+        return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + (hi - lo + 1))));
+    }
+
+    TARGET_SSE2 inline __m128i classify16(__m128i x, int kind) {
+        __m128i letters = inRange16(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 'z');
+        switch (kind) {
+        case RUN_IDENT:
+            return _mm_or_si128(_mm_or_si128(letters, inRange16(x, '0', '9')), _mm_cmpeq_epi8(x, _mm_set1_epi8('_')));
+        case RUN_LETTER:
+            return letters;
+        case RUN_DIGIT:
+            return inRange16(x, '0', '9');
+        default:
+            return _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+                _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\t')),
+                    _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\v')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\f')))));
+        }
+    }
+
+    TARGET_SSE2 size_t runSse2(const char* p, const char* end, int kind) {
+        const char* start = p;
+        if (p == end || !matches(*p, kind)) {
+            return 0; // короткие лексемы не стоят загрузки вектора
+        }
+        while (end - p >= 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(classify16(block, kind)));
+            if (bits != 0xFFFFu) {
+                return static_cast<size_t>(p - start) + countTrailingZeros(~bits);
+            }
+            p += 16;
+        }
+        return static_cast<size_t>(p - start) + runScalar(p, end, kind);
+    }
+
+    // Биты маски - переводы строк блока, начинающегося с p
+    inline void pushNewlines(const char* begin, const char* p, uint32_t bits, std::vector<uint32_t>& starts) {
+        while (bits != 0) {
+            starts.push_back(static_cast<uint32_t>(p - begin) + countTrailingZeros(bits) + 1);
+            bits &= bits - 1;
+        }
+    }
+
+    TARGET_SSE2 void newlinesSse2(const char* begin, const char* p, const char* end, std::vector<uint32_t>& starts) {
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; end - p >= 16; p += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            pushNewlines(begin, p, static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline))), starts);
+        }
+        newlinesScalar(begin, p, end, starts);
+    }
+
+    TARGET_AVX2 inline __m256i inRange32(__m256i x, char lo, char hi) {
+        __m256i shifted = _mm256_add_epi8(x, _mm256_set1_epi8(static_cast<char>(0x80 - lo)));
+        return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(-128 + (hi - lo + 1))), shifted);
+    }
+
+    TARGET_AVX2 inline __m256i classify32(__m256i x, int kind) {
+        __m256i letters = inRange32(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 'z');
+        switch (kind) {
+        case RUN_IDENT:
+            return _mm256_or_si256(_mm256_or_si256(letters, inRange32(x, '0', '9')),
+                _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_')));
+        case RUN_LETTER:
+            return letters;
+        case RUN_DIGIT:
+            return inRange32(x, '0', '9');
+        default:
+            return _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+                _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\t')),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\v')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\f')))));
+        }
+    }
+
+    TARGET_AVX2 size_t runAvx2(const char* p, const char* end, int kind) {
+        const char* start = p;
+        if (p == end || !matches(*p, kind)) {
+            return 0;
+        }
+        while (end - p >= 32) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(classify32(block, kind)));
+            if (bits != 0xFFFFFFFFu) {
+                return static_cast<size_t>(p - start) + countTrailingZeros(~bits);
+            }
+            p += 32;
+        }
+        return static_cast<size_t>(p - start) + runSse2(p, end, kind);
+    }
+
+    TARGET_AVX2 void newlinesAvx2(const char* begin, const char* p, const char* end, std::vector<uint32_t>& starts) {
+        const __m256i newline = _mm256_set1_epi8('\n');
+        for (; end - p >= 32; p += 32) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            pushNewlines(begin, p, static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline))), starts);
+        }
+        newlinesSse2(begin, p, end, starts);
+    }
+
+    bool cpuHasSse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+        return true;
+#elif defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 1);
+        return (info[3] & (1 << 26)) != 0;
+#else
+        return __builtin_cpu_supports("sse2");
+#endif
+    }
+
+    bool cpuHasAvx2() {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+        __cpuidex(info, 7, 0);
+        return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#endif // CHARSCANNER_X86
+
+    struct Dispatch {
+        size_t (*run)(const char*, const char*, int);
+        void (*newlines)(const char*, const char*, const char*, std::vector<uint32_t>&);
+        const char* name;
+    };
+
+    Dispatch selectImplementation() {
+#ifdef CHARSCANNER_X86
+        if (cpuHasAvx2()) {
+            return { runAvx2, newlinesAvx2, "AVX2" };
+        }
+        if (cpuHasSse2()) {
+            return { runSse2, newlinesSse2, "SSE2" };
+        }
+#endif
+        return { runScalar, newlinesScalar, "scalar" };
+    }
+
+    const Dispatch active = selectImplementation();
+
+}
+
+size_t CharScanner::identRun(const char* p, const char* end) {
+    return active.run(p, end, RUN_IDENT);
+}
+
+size_t CharScanner::letterRun(const char* p, const char* end) {
+    return active.run(p, end, RUN_LETTER);
+}
+
+size_t CharScanner::digitRun(const char* p, const char* end) {
+    return active.run(p, end, RUN_DIGIT);
+}
+
+size_t CharScanner::spaceRun(const char* p, const char* end) {
+    return active.run(p, end, RUN_SPACE);
+}
+
+void CharScanner::newlineEnds(const char* begin, const char* end, std::vector<uint32_t>& starts) {
+    active.newlines(begin, begin, end, starts);
+}
+
+const char* CharScanner::instructionSet() {
+    return active.name;
+}
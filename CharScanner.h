@@ -0,0 +1,25 @@
+﻿#ifndef CHARSCANNER_H
+#define CHARSCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Поиск конца серии символов одного класса. Каждая функция возвращает длину серии,
+// начинающейся с p (0, если первый символ уже не подходит), и не читает за end.
+// Реализация выбирается один раз при запуске: AVX2 (32 байта за шаг), SSE2 (16 байт)
+// или обычный цикл, поэтому один и тот же исполняемый файл работает на любом процессоре.
+class CharScanner {
+public:
+    static size_t identRun(const char* p, const char* end);  // [A-Za-z0-9_]
+    static size_t letterRun(const char* p, const char* end); // [A-Za-z]
+    static size_t digitRun(const char* p, const char* end);  // [0-9]
+    static size_t spaceRun(const char* p, const char* end);  // ' ', '\t', '\v', '\f' (без переводов строк)
+
+    // Добавляет в starts смещение (от begin) символа после каждого '\n' в [begin, end)
+    static void newlineEnds(const char* begin, const char* end, std::vector<uint32_t>& starts);
+
+    static const char* instructionSet(); // "AVX2", "SSE2" или "scalar"
+};
+
+#endif // CHARSCANNER_H
@@ -1,11 +1,155 @@
 ﻿#include <iostream>
 #include <fstream>
+#include <string>
+#include <algorithm>
 #include "LexicalAnalyzer.h"
 #include "SintaksisAnalyzer.h"
 #include "Token.h"
 #include "TokenList.h"
+#include "DfaLexer.h"
+#include "SourceBuffer.h"
+#include "ParallelLexer.h"
+#include "Trace.h"
+#include "AstSnapshot.h"
 
-int main() {
+static int compareTokenLists(const char* name, const TokenList& expected, const TokenList& actual) {
+    int count = std::min(expected.getTokenCount(), actual.getTokenCount());
+    for (int i = 0; i < count; ++i) {
+        if (expected.getType(i) != actual.getType(i) || expected.getLexeme(i) != actual.getLexeme(i)
+            || expected.getSymbol(i) != actual.getSymbol(i)) {
+            std::cout << name << ": token #" << i << " differs: \"" << expected.getLexeme(i) << "\" vs \"" << actual.getLexeme(i) << "\"" << std::endl;
+            return 1;
+        }
+    }
+    if (expected.getTokenCount() != actual.getTokenCount()) {
+        std::cout << name << ": token count differs: " << expected.getTokenCount() << " vs " << actual.getTokenCount() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// Сравнение потоков токенов LexicalAnalyzer, DfaLexer и ParallelLexer на одном входном файле.
+// ParallelLexer запускается с частями по 64 байта, чтобы склейка проверялась и на маленьких файлах.
+static int compareLexers(const std::string& inputFileName) {
+    LexicalAnalyzer lexer(inputFileName);
+    lexer.tokenize();
+    const TokenList& expected = lexer.getTokenList();
+
+    SourceBuffer source;
+    source.open(inputFileName);
+    TokenList dfa;
+    dfa.setSource(source.begin(), source.end());
+    DfaLexer(source.begin(), source.end()).tokenize(dfa);
+    TokenList parallel;
+    parallel.setSource(source.begin(), source.end());
+    ParallelLexer(4, 64).tokenize(source.begin(), source.end(), parallel);
+
+    if (compareTokenLists("DfaLexer", expected, dfa) || compareTokenLists("ParallelLexer", expected, parallel)) {
+        return 1;
+    }
+    std::cout << "Token streams match: " << expected.getTokenCount() << " tokens." << std::endl;
+    return 0;
+}
+
+// Только лексический анализ с разбором по частям в нескольких потоках; таблица токенов в output.txt
+static int parallelLex(unsigned threadCount) {
+    LexicalAnalyzer lexer("input.txt");
+    lexer.tokenizeParallel(threadCount);
+    std::ofstream outputFile("output.txt");
+    lexer.getTokenList().printTokens(outputFile);
+    return 0;
+}
+
+// Статистика таблицы символов после лексического анализа input.txt
+static int symbolStats() {
+    LexicalAnalyzer lexer("input.txt");
+    lexer.tokenize();
+    const SymbolTable::ProbeStats& stats = lexer.getTokenList().getSymbolTable().getProbeStats();
+    std::cout << "Tokens: " << lexer.getTokenList().getTokenCount() << std::endl;
+    std::cout << "Symbols: " << stats.symbols << " in " << stats.capacity << " slots (load " << stats.loadFactor() << ")" << std::endl;
+    std::cout << "Lookups: " << stats.lookups << ", average probe length " << stats.averageProbes()
+        << ", longest " << stats.maxProbes << std::endl;
+    return 0;
+}
+
+// Токены input.txt со строкой и столбцом начала каждого
+static int printPositions() {
+    LexicalAnalyzer lexer("input.txt");
+    lexer.tokenize();
+    const TokenList& tokens = lexer.getTokenList();
+    for (int i = 0; i < tokens.getTokenCount(); ++i) {
+        LineIndex::Position position = lexer.getLineIndex().locate(tokens.getStream().getOffset(i));
+        std::cout << position.line << ":" << position.column << "\t" << tokenTypeName(tokens.getType(i))
+            << "\t" << tokens.getLexeme(i) << std::endl;
+    }
+    return 0;
+}
+
+// Проверка input.txt без дерева разбора и выходных файлов: сообщения на экран, код возврата 1 при ошибках
+static int checkOnly() {
+    LexicalAnalyzer lexer("input.txt");
+    return lexer.check() ? 0 : 1;
+}
+
+// Разбор input.txt как обычно и снимок дерева в двоичном файле
+static int saveAst(const std::string& fileName) {
+    LexicalAnalyzer lexer("input.txt", "output.txt");
+    lexer.analyze();
+    lexer.sintaksis_analyzer.Saving_Tree(fileName);
+    return 0;
+}
+
+// Дерево из снимка, напечатанное так же, как parsing_tree.txt; input.txt не читается
+static int loadAst(const std::string& fileName) {
+    AstSnapshot snapshot;
+    if (!snapshot.open(fileName)) {
+        std::cout << "Cannot open AST snapshot " << fileName << std::endl;
+        return 1;
+    }
+    snapshot.printTree(std::cout);
+    return 0;
+}
+
+// Группы одинаковых поддеревьев input.txt не меньше minNodes узлов: число повторов и первое вхождение
+static int printDuplicates(uint32_t minNodes) {
+    LexicalAnalyzer lexer("input.txt", "output.txt");
+    lexer.analyze();
+    const FlatTree& tree = lexer.sintaksis_analyzer.flat_tree();
+    for (const std::vector<uint32_t>& group : tree.groupIdenticalSubtrees(minNodes)) {
+        std::cout << group.size() << " x " << tree.subtreeSize(group.front()) << " nodes:" << std::endl;
+        tree.printTree(std::cout, tree.getMaxLevel(1, group.front()), 1, 2, group.front());
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+#if TRACE_ENABLED
+    Trace::dumpAtExit("debug_log.txt");
+#endif
+    if (argc > 1 && std::string(argv[1]) == "--compare-lexers") {
+        return compareLexers("input.txt");
+    }
+    if (argc > 1 && std::string(argv[1]) == "--positions") {
+        return printPositions();
+    }
+    if (argc > 1 && std::string(argv[1]) == "--symbol-stats") {
+        return symbolStats();
+    }
+    if (argc > 1 && std::string(argv[1]) == "--parallel-lex") {
+        return parallelLex(argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 0);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--check") {
+        return checkOnly();
+    }
+    if (argc > 1 && std::string(argv[1]) == "--duplicates") {
+        return printDuplicates(argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 3);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--save-ast") {
+        return saveAst(argc > 2 ? argv[2] : "parsing_tree.ast");
+    }
+    if (argc > 1 && std::string(argv[1]) == "--load-ast") {
+        return loadAst(argc > 2 ? argv[2] : "parsing_tree.ast");
+    }
     LexicalAnalyzer lexer("input.txt", "output.txt");
     lexer.analyze();
     return 0;
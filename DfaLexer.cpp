@@ -0,0 +1,430 @@
+﻿#include "DfaLexer.h"
+#include "CharScanner.h"
+#include "Trace.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace {
+
+    // Классы символов. Буквы из PROGRAM и END выделены отдельно:
+    // по ним автомат распознаёт эти слова без повторного чтения.
+    enum CharClass : uint8_t {
+        C_LF, C_CR, C_SPACE,
+        C_P, C_R, C_O, C_G, C_A, C_M, C_E, C_N, C_D, C_ALPHA,
+        C_DIGIT, C_UNDER, C_EQ, C_PLUS, C_MINUS, C_DELIM, C_COLON,
+        C_FF,    // байт 0xFF: LexicalAnalyzer сравнивает char с EOF и принимает его за конец файла
+        C_OTHER,
+        C_EOF,   // конец входа
+        CLASS_COUNT
+    };
+
+    enum State : uint8_t {
+        S_START,
+        S_IDENT, S_IDENT_BAD,         // идентификатор / слово с цифрами или '_'
+        S_NUMBER, S_NUMBER_BAD,
+        S_PLUS, S_MINUS,              // проверка на ++ и --
+        S_JUNK,                       // посторонние символы до пробела или разделителя
+        S_P1, S_P2, S_P3, S_P4, S_P5, S_P6, S_P7, // прочитано "P" ... "PROGRAM"
+        S_E1, S_E2, S_E3,             // прочитано "E" ... "END"
+        S_RUN, S_RUN_BAD,             // слово на P/E, не ставшее ключевым: читается до пробела
+        S_PROG_ERR,                   // "PROGRAM" + лишние символы
+        S_END_ERR,                    // "END" + лишние символы
+        S_PROG_SKIP,                  // пробелы между PROGRAM и именем программы
+        S_PROG_ID, S_PROG_ID_BAD,     // имя программы
+        STATE_COUNT
+    };
+
+    enum Action : uint8_t {
+        A_SHIFT,         // взять символ и перейти в next
+        A_SKIP,          // пробел перед токеном
+        A_NEWLINE,       // перевод строки перед токеном: END_LINE
+        A_MARK,          // начало имени программы
+        A_ACCEPT,        // токен закончился перед текущим символом
+        A_ACCEPT_SHIFT,  // токен закончился текущим символом
+        A_ACCEPT_DROP,   // текущий символ съедается, но в токен не входит
+        A_DONE           // конец входа
+    };
+
+    // Что выдаётся при допуске
+    enum Kind : uint8_t {
+        K_NONE,
+        K_IDENT,        // ключевое слово или ID_NAME
+        K_NUMBER,
+        K_OPERATOR,
+        K_DELIMITER,
+        K_ERROR,
+        K_WORD,         // ID_NAME без проверки ключевых слов
+        K_WORD_DUP,     // ID_NAME, последний символ повторён (вход кончился внутри PROGRAM/END)
+        K_ERROR_DUP,    // то же для ERROR ("PROGRAMM")
+        K_BEGIN,        // PROGRAM + BEGIN(имя)
+        K_BAD_ID,       // ERROR(имя программы)
+        K_EMPTY,        // ERROR("") - после PROGRAM ничего нет
+        K_END,          // END дважды, как в LexicalAnalyzer
+        K_END_ERROR,    // ERROR("END " + остаток)
+        K_END_DUP       // ERROR("END D")
+    };
+
+    struct Transition {
+        uint8_t next;
+        uint8_t action;
+        uint8_t kind;
+    };
+
+    constexpr std::array<uint8_t, 256> makeCharClasses() {
+        std::array<uint8_t, 256> table{};
+        for (int c = 0; c < 256; ++c) {
+            uint8_t cls = C_OTHER;
+            if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) cls = C_ALPHA;
+            else if (c >= '0' && c <= '9') cls = C_DIGIT;
+            else if (c == ' ' || c == '\t' || c == '\v' || c == '\f') cls = C_SPACE;
+            table[c] = cls;
+        }
+        table['\n'] = C_LF;
+        table['\r'] = C_CR;
+        table['P'] = C_P;
+        table['R'] = C_R;
+        table['O'] = C_O;
+        table['G'] = C_G;
+        table['A'] = C_A;
+        table['M'] = C_M;
+        table['E'] = C_E;
+        table['N'] = C_N;
+        table['D'] = C_D;
+        table['_'] = C_UNDER;
+        table['='] = C_EQ;
+        table['+'] = C_PLUS;
+        table['-'] = C_MINUS;
+        table[':'] = C_COLON;
+        table[0xFF] = C_FF;
+        for (char c : { '(', ')', ',', ';', '\'', '"', '.' }) {
+            table[static_cast<unsigned char>(c)] = C_DELIM;
+        }
+        return table;
+    }
+
+    constexpr std::array<uint8_t, 256> charClasses = makeCharClasses();
+
+    constexpr bool isLetter(int cls) { return cls >= C_P && cls <= C_ALPHA; }
+    constexpr bool isSpace(int cls) { return cls == C_LF || cls == C_CR || cls == C_SPACE; }
+
+    using TransitionTable = std::array<std::array<Transition, CLASS_COUNT>, STATE_COUNT>;
+
+    constexpr void fill(TransitionTable& table, int state, Transition t) {
+        for (int cls = 0; cls < CLASS_COUNT; ++cls) table[state][cls] = t;
+    }
+
+    // Слово на P/E, не совпавшее с PROGRAM/END: несовпавший символ входит в слово всегда
+    constexpr void keywordPrefix(TransitionTable& table, int state, int expected, int next, Kind kindAtEof) {
+        for (int cls = 0; cls < CLASS_COUNT; ++cls) {
+            table[state][cls] = { uint8_t(isLetter(cls) ? S_RUN : S_RUN_BAD), A_SHIFT, K_NONE };
+        }
+        table[state][expected] = { uint8_t(next), A_SHIFT, K_NONE };
+        table[state][C_EOF] = { uint8_t(state), A_ACCEPT, uint8_t(kindAtEof) };
+    }
+
+    // Хвост до пробела (или байта 0xFF): разделитель съедается, но в слово не входит
+    constexpr void runToSpace(TransitionTable& table, int state, Kind kind) {
+        fill(table, state, { uint8_t(state), A_SHIFT, K_NONE });
+        for (int cls : { C_LF, C_CR, C_SPACE, C_FF }) table[state][cls] = { uint8_t(state), A_ACCEPT_DROP, uint8_t(kind) };
+        table[state][C_EOF] = { uint8_t(state), A_ACCEPT, uint8_t(kind) };
+    }
+
+    constexpr TransitionTable makeTransitions() {
+        TransitionTable table{};
+
+        // Начальное состояние
+        fill(table, S_START, { S_JUNK, A_SHIFT, K_NONE });
+        table[S_START][C_LF] = { S_START, A_NEWLINE, K_NONE };
+        table[S_START][C_CR] = { S_START, A_NEWLINE, K_NONE };
+        table[S_START][C_SPACE] = { S_START, A_SKIP, K_NONE };
+        for (int cls = C_R; cls <= C_ALPHA; ++cls) table[S_START][cls] = { S_IDENT, A_SHIFT, K_NONE };
+        table[S_START][C_P] = { S_P1, A_SHIFT, K_NONE };
+        table[S_START][C_E] = { S_E1, A_SHIFT, K_NONE };
+        table[S_START][C_DIGIT] = { S_NUMBER, A_SHIFT, K_NONE };
+        table[S_START][C_EQ] = { S_START, A_ACCEPT_SHIFT, K_OPERATOR };
+        table[S_START][C_PLUS] = { S_PLUS, A_SHIFT, K_NONE };
+        table[S_START][C_MINUS] = { S_MINUS, A_SHIFT, K_NONE };
+        table[S_START][C_DELIM] = { S_START, A_ACCEPT_SHIFT, K_DELIMITER };
+        table[S_START][C_EOF] = { S_START, A_DONE, K_NONE };
+
+        // Идентификаторы и числа: [A-Za-z0-9_]*, годные только из букв / только из цифр
+        fill(table, S_IDENT, { S_IDENT, A_ACCEPT, K_IDENT });
+        fill(table, S_IDENT_BAD, { S_IDENT_BAD, A_ACCEPT, K_ERROR });
+        fill(table, S_NUMBER, { S_NUMBER, A_ACCEPT, K_NUMBER });
+        fill(table, S_NUMBER_BAD, { S_NUMBER_BAD, A_ACCEPT, K_ERROR });
+        for (int cls = C_P; cls <= C_UNDER; ++cls) {
+            table[S_IDENT][cls] = { uint8_t(isLetter(cls) ? S_IDENT : S_IDENT_BAD), A_SHIFT, K_NONE };
+            table[S_IDENT_BAD][cls] = { S_IDENT_BAD, A_SHIFT, K_NONE };
+            table[S_NUMBER][cls] = { uint8_t(cls == C_DIGIT ? S_NUMBER : S_NUMBER_BAD), A_SHIFT, K_NONE };
+            table[S_NUMBER_BAD][cls] = { S_NUMBER_BAD, A_SHIFT, K_NONE };
+        }
+
+        // ++ и -- - ошибка, одиночный знак - оператор
+        fill(table, S_PLUS, { S_PLUS, A_ACCEPT, K_OPERATOR });
+        table[S_PLUS][C_PLUS] = { S_PLUS, A_ACCEPT_SHIFT, K_ERROR };
+        fill(table, S_MINUS, { S_MINUS, A_ACCEPT, K_OPERATOR });
+        table[S_MINUS][C_MINUS] = { S_MINUS, A_ACCEPT_SHIFT, K_ERROR };
+
+        // Посторонние символы - до пробела или разделителя
+        fill(table, S_JUNK, { S_JUNK, A_SHIFT, K_NONE });
+        for (int cls : { C_LF, C_CR, C_SPACE, C_DELIM, C_EOF }) table[S_JUNK][cls] = { S_JUNK, A_ACCEPT, K_ERROR };
+
+        // PROGRAM
+        keywordPrefix(table, S_P1, C_R, S_P2, K_WORD_DUP);
+        keywordPrefix(table, S_P2, C_O, S_P3, K_WORD_DUP);
+        keywordPrefix(table, S_P3, C_G, S_P4, K_WORD_DUP);
+        keywordPrefix(table, S_P4, C_R, S_P5, K_WORD_DUP);
+        keywordPrefix(table, S_P5, C_A, S_P6, K_WORD_DUP);
+        keywordPrefix(table, S_P6, C_M, S_P7, K_WORD_DUP);
+        fill(table, S_P7, { S_PROG_ERR, A_SHIFT, K_NONE });
+        for (int cls : { C_LF, C_CR, C_SPACE, C_COLON, C_FF }) table[S_P7][cls] = { S_PROG_SKIP, A_SHIFT, K_NONE };
+        table[S_P7][C_EOF] = { S_P7, A_ACCEPT, K_ERROR_DUP };
+        runToSpace(table, S_PROG_ERR, K_ERROR);
+
+        fill(table, S_PROG_SKIP, { S_PROG_ID_BAD, A_MARK, K_NONE });
+        for (int cls = C_P; cls <= C_ALPHA; ++cls) table[S_PROG_SKIP][cls] = { S_PROG_ID, A_MARK, K_NONE };
+        for (int cls : { C_LF, C_CR, C_SPACE }) table[S_PROG_SKIP][cls] = { S_PROG_SKIP, A_SHIFT, K_NONE };
+        table[S_PROG_SKIP][C_EOF] = { S_PROG_SKIP, A_ACCEPT, K_EMPTY };
+
+        fill(table, S_PROG_ID, { S_PROG_ID_BAD, A_SHIFT, K_NONE });
+        for (int cls = C_P; cls <= C_ALPHA; ++cls) table[S_PROG_ID][cls] = { S_PROG_ID, A_SHIFT, K_NONE };
+        fill(table, S_PROG_ID_BAD, { S_PROG_ID_BAD, A_SHIFT, K_NONE });
+        for (int cls : { C_LF, C_CR, C_SPACE, C_EOF }) {
+            table[S_PROG_ID][cls] = { S_PROG_ID, A_ACCEPT, K_BEGIN };
+            table[S_PROG_ID_BAD][cls] = { S_PROG_ID_BAD, A_ACCEPT, K_BAD_ID };
+        }
+
+        // END
+        keywordPrefix(table, S_E1, C_N, S_E2, K_WORD_DUP);
+        keywordPrefix(table, S_E2, C_D, S_E3, K_WORD_DUP);
+        fill(table, S_E3, { S_END_ERR, A_SHIFT, K_NONE });
+        for (int cls : { C_LF, C_CR, C_SPACE, C_COLON, C_FF }) table[S_E3][cls] = { S_E3, A_ACCEPT_SHIFT, K_END };
+        table[S_E3][C_EOF] = { S_E3, A_ACCEPT, K_END_DUP };
+        runToSpace(table, S_END_ERR, K_END_ERROR);
+
+        // Хвосты слов на P/E
+        runToSpace(table, S_RUN, K_WORD);
+        for (int cls = 0; cls < C_EOF; ++cls) {
+            if (!isLetter(cls) && !isSpace(cls) && cls != C_FF) table[S_RUN][cls] = { S_RUN_BAD, A_SHIFT, K_NONE };
+        }
+        runToSpace(table, S_RUN_BAD, K_ERROR);
+
+        return table;
+    }
+
+    constexpr TransitionTable transitions = makeTransitions();
+
+    // Состояния, в которых автомат стоит на месте длинными сериями символов:
+    // при входе в них вся серия пропускается векторным ядром CharScanner
+    enum RunKind : uint8_t { R_NONE, R_LETTERS, R_IDENT, R_DIGITS };
+
+    constexpr std::array<uint8_t, STATE_COUNT> makeStateRuns() {
+        std::array<uint8_t, STATE_COUNT> runs{};
+        runs[S_IDENT] = R_LETTERS;
+        runs[S_IDENT_BAD] = R_IDENT;
+        runs[S_NUMBER] = R_DIGITS;
+        runs[S_NUMBER_BAD] = R_IDENT;
+        runs[S_RUN] = R_LETTERS;
+        runs[S_PROG_ID] = R_LETTERS;
+        return runs;
+    }
+
+    constexpr std::array<uint8_t, STATE_COUNT> stateRuns = makeStateRuns();
+
+    inline size_t runLength(uint8_t state, const char* p, const char* end) {
+        switch (stateRuns[state]) {
+        case R_LETTERS:
+            return CharScanner::letterRun(p, end);
+        case R_IDENT:
+            return CharScanner::identRun(p, end);
+        case R_DIGITS:
+            return CharScanner::digitRun(p, end);
+        default:
+            return 0;
+        }
+    }
+
+    // Ключевые слова: совершенная хеш-функция по первому символу и длине
+    struct Keyword {
+        const char* text;
+        size_t length;
+        TokenType type;
+    };
+
+    constexpr Keyword keywords[] = {
+        { "INTEGER", 7, TokenType::TYPE },
+        { "DO", 2, TokenType::OP },
+        { "TO", 2, TokenType::OP },
+        { "FOR", 3, TokenType::OP },
+    };
+
+    constexpr size_t KEYWORD_SLOTS = 8;
+
+    constexpr size_t keywordSlot(unsigned char first, size_t length) {
+        return (first ^ (first >> 3) ^ length) & (KEYWORD_SLOTS - 1);
+    }
+
+    constexpr std::array<Keyword, KEYWORD_SLOTS> makeKeywordTable() {
+        std::array<Keyword, KEYWORD_SLOTS> table{};
+        for (const Keyword& keyword : keywords) {
+            table[keywordSlot(static_cast<unsigned char>(keyword.text[0]), keyword.length)] = keyword;
+        }
+        return table;
+    }
+
+    constexpr bool keywordSlotsAreUnique() {
+        for (size_t i = 0; i < sizeof(keywords) / sizeof(keywords[0]); ++i) {
+            for (size_t j = i + 1; j < sizeof(keywords) / sizeof(keywords[0]); ++j) {
+                if (keywordSlot(static_cast<unsigned char>(keywords[i].text[0]), keywords[i].length) ==
+                    keywordSlot(static_cast<unsigned char>(keywords[j].text[0]), keywords[j].length)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static_assert(keywordSlotsAreUnique(), "keyword hash is not perfect, change keywordSlot");
+
+    constexpr std::array<Keyword, KEYWORD_SLOTS> keywordTable = makeKeywordTable();
+
+    TokenType lookupKeyword(const char* text, size_t length) {
+        const Keyword& keyword = keywordTable[keywordSlot(static_cast<unsigned char>(text[0]), length)];
+        if (keyword.length == length && std::memcmp(keyword.text, text, length) == 0) {
+            return keyword.type;
+        }
+        return TokenType::ID_NAME;
+    }
+
+}
+
+DfaLexer::DfaLexer(const char* begin, const char* end) : cursor(begin), end(end) {}
+
+void DfaLexer::tokenize(TokenList& tokens) {
+    while (next(tokens)) {
+    }
+}
+
+bool DfaLexer::next(TokenList& tokens) {
+    return step(tokens);
+}
+
+bool DfaLexer::next(TokenStream& tokens) {
+    return step(tokens);
+}
+
+template <class Sink>
+bool DfaLexer::step(Sink& tokens) {
+    uint8_t state = S_START;
+    int index = 1;
+    const char* tokenStart = cursor;
+    const char* idStart = cursor;
+
+    for (;;) {
+        uint8_t cls = cursor == end ? uint8_t(C_EOF) : charClasses[static_cast<unsigned char>(*cursor)];
+#ifdef _WIN32
+        // Текстовый режим ifstream превращал "\r\n" в '\n'
+        if (cls == C_CR && cursor + 1 != end && cursor[1] == '\n') {
+            ++cursor;
+            cls = C_LF;
+        }
+#endif
+        TRACE(LEXER, 3, "Current State: %u, Current Char: %c", state, cursor != end ? *cursor : ' ');
+        const Transition& t = transitions[state][cls];
+        switch (t.action) {
+        case A_SHIFT:
+            ++cursor;
+            if (state != t.next) {
+                state = t.next;
+                cursor += runLength(state, cursor, end);
+            }
+            break;
+        case A_SKIP: {
+            size_t run = CharScanner::spaceRun(cursor + 1, end);
+            cursor += 1 + run;
+            index += 1 + static_cast<int>(run);
+            tokenStart = cursor;
+            break;
+        }
+        case A_NEWLINE:
+            tokens.addToken(Token(TokenType::END_LINE, "END_LINE", index, cursor));
+            ++cursor;
+            ++index;
+            tokenStart = cursor;
+            break;
+        case A_MARK:
+            idStart = cursor;
+            ++cursor;
+            state = t.next;
+            cursor += runLength(state, cursor, end);
+            break;
+        case A_ACCEPT:
+            emit(tokens, t.kind, tokenStart, idStart, cursor, index);
+            return true;
+        case A_ACCEPT_SHIFT:
+            ++cursor;
+            emit(tokens, t.kind, tokenStart, idStart, cursor, index);
+            return true;
+        case A_ACCEPT_DROP:
+            emit(tokens, t.kind, tokenStart, idStart, cursor, index);
+            ++cursor;
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+template <class Sink>
+void DfaLexer::emit(Sink& tokens, unsigned char kind, const char* tokenStart, const char* idStart,
+    const char* stop, int index) const {
+    std::string_view text(tokenStart, stop - tokenStart);
+    switch (kind) {
+    case K_IDENT:
+        tokens.addToken(Token(lookupKeyword(tokenStart, text.size()), text, index));
+        break;
+    case K_NUMBER:
+        tokens.addToken(Token(TokenType::INT_NUM, text, index));
+        break;
+    case K_OPERATOR:
+        tokens.addToken(Token(TokenType::OPERATOR, text, index));
+        break;
+    case K_DELIMITER:
+        tokens.addToken(Token(TokenType::DELIMITER, text, index));
+        break;
+    case K_ERROR:
+        tokens.addToken(Token(TokenType::ERROR, text, index));
+        break;
+    case K_WORD:
+        tokens.addToken(Token(TokenType::ID_NAME, text, index));
+        break;
+    case K_WORD_DUP:
+        tokens.addToken(Token(TokenType::ID_NAME, std::string(text) + text.back(), index, tokenStart));
+        break;
+    case K_ERROR_DUP:
+        tokens.addToken(Token(TokenType::ERROR, std::string(text) + text.back(), index, tokenStart));
+        break;
+    case K_BEGIN:
+        tokens.addToken(Token(TokenType::PROGRAM, text.substr(0, 7), index));
+        tokens.addToken(Token(TokenType::BEGIN, std::string_view(idStart, stop - idStart), index + 1));
+        break;
+    case K_BAD_ID:
+        tokens.addToken(Token(TokenType::ERROR, std::string_view(idStart, stop - idStart), index));
+        break;
+    case K_EMPTY:
+        tokens.addToken(Token(TokenType::ERROR, "", index, tokenStart));
+        break;
+    case K_END:
+        tokens.addToken(Token(TokenType::END, text.substr(0, 3), index));
+        tokens.addToken(Token(TokenType::END, text.substr(0, 3), index));
+        break;
+    case K_END_ERROR:
+        tokens.addToken(Token(TokenType::ERROR, "END " + std::string(text.substr(3)), index, tokenStart));
+        break;
+    case K_END_DUP:
+        tokens.addToken(Token(TokenType::ERROR, "END D", index, tokenStart));
+        break;
+    }
+}
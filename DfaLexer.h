@@ -0,0 +1,36 @@
+﻿#ifndef DFALEXER_H
+#define DFALEXER_H
+
+#include "Token.h"
+#include "TokenList.h"
+#include "TokenStream.h"
+
+// Табличный лексер. Классы символов, переходы автомата и таблица ключевых слов
+// строятся на этапе компиляции (см. DfaLexer.cpp), каждый символ читается один раз.
+// Поток токенов совпадает с LexicalAnalyzer вместе со всеми его особенностями
+// разбора PROGRAM и END, поэтому результаты двух лексеров можно сравнивать.
+class DfaLexer {
+public:
+    DfaLexer(const char* begin, const char* end);
+
+    // Разбирает весь вход, добавляя токены в tokens
+    void tokenize(TokenList& tokens);
+
+    // Один шаг, аналог LexicalAnalyzer::getNextLexeme; false - вход закончился
+    bool next(TokenList& tokens);
+    bool next(TokenStream& tokens); // то же без таблицы символов (разбор по частям в ParallelLexer)
+
+    const char* position() const { return cursor; }
+
+private:
+    template <class Sink>
+    bool step(Sink& tokens);
+    template <class Sink>
+    void emit(Sink& tokens, unsigned char kind, const char* tokenStart, const char* idStart,
+        const char* stop, int index) const;
+
+    const char* cursor;
+    const char* end;
+};
+
+#endif // DFALEXER_H
@@ -0,0 +1,203 @@
+﻿#include "FlatTree.h"
+#include "TreeNode.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+    std::string_view trimSpaces(std::string_view text) {
+        size_t first = text.find_first_not_of(' ');
+        if (first == std::string_view::npos) {
+            return std::string_view();
+        }
+        return text.substr(first, text.find_last_not_of(' ') - first + 1);
+    }
+
+    // Перемешивание из splitmix64
+    uint64_t mix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+        return x ^ (x >> 31);
+    }
+
+    // Несимметрично: порядок сыновей входит в хэш
+    uint64_t combine(uint64_t seed, uint64_t value) {
+        return mix(seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2)));
+    }
+
+}
+
+void FlatTree::build(const TreeNode* root) {
+    nodes.clear();
+    if (root == nullptr) {
+        return;
+    }
+
+    // Прямой порядок на явном стеке: над следующим братом узла кладётся его первый сын,
+    // поэтому стек не глубже дерева; lastChild - последний уже записанный сын узла
+    std::vector<uint32_t> lastChild;
+    std::vector<std::pair<const TreeNode*, uint32_t>> pending = { { root, NONE } };
+    while (!pending.empty()) {
+        auto [node, parent] = pending.back();
+        pending.pop_back();
+        if (node->getNextSibling() && parent != NONE) {
+            pending.push_back({ node->getNextSibling(), parent });
+        }
+
+        uint32_t index = size();
+        uint32_t depth = parent == NONE ? 0 : nodes[parent].depth + 1;
+        nodes.push_back({ node->getSymbol(), node->getKind(), NONE, NONE, parent, 0, depth, 0, 0, node->getLevel() });
+        lastChild.push_back(NONE);
+        if (parent != NONE) {
+            if (lastChild[parent] == NONE) {
+                nodes[parent].firstChild = index;
+            }
+            else {
+                nodes[lastChild[parent]].nextSibling = index;
+            }
+            lastChild[parent] = index;
+        }
+
+        if (node->getFirstChild()) {
+            pending.push_back({ node->getFirstChild(), index });
+        }
+    }
+
+    // Родитель стоит раньше сына, поэтому его конец уже известен
+    for (uint32_t i = 0; i < size(); ++i) {
+        Node& node = nodes[i];
+        node.end = node.nextSibling != NONE ? node.nextSibling : node.parent != NONE ? nodes[node.parent].end : size();
+    }
+    // А высоты и хэши - с конца: к узлу все его потомки уже учтены. До своей очереди
+    // hash узла копит хэши сыновей (от последнего к первому), потом к ним добавляется сам узел
+    for (uint32_t i = size(); i-- > 0;) {
+        Node& node = nodes[i];
+        uint64_t label = (static_cast<uint64_t>(node.symbol) << 8) | static_cast<uint8_t>(node.kind);
+        node.hash = combine(mix(label), node.hash);
+        if (node.parent != NONE) {
+            Node& parent = nodes[node.parent];
+            parent.height = std::max(parent.height, node.height + 1);
+            parent.hash = combine(parent.hash, node.hash);
+        }
+    }
+}
+
+bool FlatTree::sameSubtree(uint32_t a, uint32_t b) const {
+    uint32_t count = subtreeSize(a);
+    if (nodes[a].hash != nodes[b].hash || subtreeSize(b) != count) {
+        return false;
+    }
+    // Прямой порядок вместе с глубинами однозначно задаёт форму дерева
+    for (uint32_t k = 0; k < count; ++k) {
+        const Node& x = nodes[a + k];
+        const Node& y = nodes[b + k];
+        if (x.symbol != y.symbol || x.kind != y.kind || x.depth - nodes[a].depth != y.depth - nodes[b].depth) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<std::vector<uint32_t>> FlatTree::groupIdenticalSubtrees(uint32_t minNodes) const {
+    std::vector<std::vector<uint32_t>> groups;
+    // На один хэш обычно одна группа; несколько - только при совпадении хэшей разных поддеревьев
+    std::unordered_map<uint64_t, std::vector<uint32_t>> byHash;
+    for (uint32_t i = 0; i < size(); ++i) {
+        if (subtreeSize(i) < minNodes) {
+            continue;
+        }
+        std::vector<uint32_t>& candidates = byHash[nodes[i].hash];
+        auto found = std::find_if(candidates.begin(), candidates.end(),
+            [&](uint32_t group) { return sameSubtree(groups[group].front(), i); });
+        if (found != candidates.end()) {
+            groups[*found].push_back(i);
+        }
+        else {
+            candidates.push_back(static_cast<uint32_t>(groups.size()));
+            groups.push_back({ i });
+        }
+    }
+    groups.erase(std::remove_if(groups.begin(), groups.end(),
+        [](const std::vector<uint32_t>& group) { return group.size() < 2; }), groups.end());
+    return groups;
+}
+
+void FlatTree::printTree(std::ostream& outFile, int maxLevel, int currentLevel, int indentation, uint32_t index) const {
+    if (index >= size()) {
+        return;
+    }
+    uint32_t top = nodes[index].depth;
+    uint32_t i = index;
+    while (i < nodes[index].end) {
+        const Node& node = nodes[i];
+        uint32_t depth = node.depth - top;
+        if (currentLevel + static_cast<int>(depth) > maxLevel) {
+            i = node.end; // потомки ещё глубже
+            continue;
+        }
+
+        outFile << std::string(indentation + 2 * depth, ' ');
+
+        outFile << Interner::text(node.symbol);
+        if (node.kind != NodeKind::NONE) outFile << " [" << nodeKindName(node.kind) << "]";
+        outFile << '\n';
+        ++i;
+    }
+}
+
+std::vector<std::string> FlatTree::collectChildStrings(int indentation) const {
+    std::vector<std::string> result;
+    if (empty()) {
+        return result;
+    }
+
+    // Открытые поддеревья: конец в массиве и начало строки поддерева в collectedString.
+    // Отступ входит в строку сына корня, но не во вложенные строки: их края обрезаются,
+    // поэтому пробел не пишется, пока строка поддерева пуста, а в конце хвост пробелов снимается.
+    struct Frame {
+        uint32_t end;
+        size_t start;
+    };
+    std::vector<Frame> frames;
+
+    for (uint32_t child = nodes[0].firstChild; child != NONE; child = nodes[child].nextSibling) {
+        std::string collectedString(indentation, ' ');
+        auto separate = [&collectedString](size_t start) {
+            if (collectedString.size() > start) {
+                collectedString += ' ';
+            }
+        };
+        auto close = [&]() {
+            size_t start = frames.back().start;
+            frames.pop_back();
+            if (!frames.empty()) {
+                while (collectedString.size() > start && collectedString.back() == ' ') {
+                    collectedString.pop_back();
+                }
+            }
+        };
+
+        for (uint32_t i = child; i < nodes[child].end; ++i) {
+            while (!frames.empty() && frames.back().end <= i) {
+                close();
+            }
+            size_t start = 0;
+            if (!frames.empty()) {
+                separate(frames.back().start);
+                start = collectedString.size();
+            }
+            // Служебные метки ("Expr", "Id", "Varlist", ...) в строки не включаются
+            if (!Interner::isServiceLabel(nodes[i].symbol)) {
+                separate(start);
+                collectedString += trimSpaces(Interner::text(nodes[i].symbol));
+            }
+            frames.push_back({ nodes[i].end, start });
+        }
+        while (!frames.empty()) {
+            close();
+        }
+        result.push_back(collectedString); // Добавляем строку в результат
+    }
+
+    return result;
+}
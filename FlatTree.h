@@ -0,0 +1,116 @@
+﻿#ifndef FLATTREE_H
+#define FLATTREE_H
+
+#include "NodeKind.h"
+#include "Interner.h"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class TreeNode;
+
+// Плоская копия дерева разбора: все узлы в одном массиве в прямом порядке (preorder),
+// связи - 32-битные номера первого сына и следующего брата. Поддерево узла i занимает
+// отрезок [i, end) массива, поэтому обходы - это проход по массиву подряд, а пропуск
+// поддерева - переход к end. Хэш поддерева считается при построении, так что поддеревья
+// с разными хэшами различаются за O(1).
+class FlatTree {
+public:
+    static constexpr uint32_t NONE = 0xFFFFFFFFu;
+
+    struct Node {
+        Interner::Symbol symbol;
+        NodeKind kind;
+        uint32_t firstChild;  // NONE, если сыновей нет; иначе всегда номер узла + 1
+        uint32_t nextSibling; // NONE у последнего сына
+        uint32_t parent;      // NONE у корня
+        uint32_t end;         // конец поддерева: номер узла после последнего потомка
+        uint32_t depth;       // 0 у корня
+        uint32_t height;      // глубина поддерева: 0 у листа
+        uint64_t hash;        // хэш поддерева по строкам и типам узлов и порядку сыновей (без level)
+        int level;            // TreeNode::getLevel()
+    };
+
+    // Узел в виде, похожем на TreeNode*: обходы, написанные для TreeNode, работают и с ним
+    class NodeRef {
+    public:
+        NodeRef(const FlatTree& tree, uint32_t index) : tree(&tree), index(index) {}
+
+        class Children {
+        public:
+            class iterator {
+            public:
+                iterator(const FlatTree* tree, uint32_t index) : tree(tree), index(index) {}
+                NodeRef operator*() const { return NodeRef(*tree, index); }
+                iterator& operator++() { index = tree->nodes[index].nextSibling; return *this; }
+                bool operator!=(const iterator& other) const { return index != other.index; }
+            private:
+                const FlatTree* tree;
+                uint32_t index;
+            };
+
+            Children(const FlatTree* tree, uint32_t first) : tree(tree), first(first) {}
+            iterator begin() const { return iterator(tree, first); }
+            iterator end() const { return iterator(tree, NONE); }
+            bool empty() const { return first == NONE; }
+        private:
+            const FlatTree* tree;
+            uint32_t first;
+        };
+
+        const NodeRef* operator->() const { return this; }
+        std::string getData() const { return std::string(Interner::text(node().symbol)); }
+        Interner::Symbol getSymbol() const { return node().symbol; }
+        std::string getType() const { return nodeKindName(node().kind); }
+        NodeKind getKind() const { return node().kind; }
+        int getLevel() const { return node().level; }
+        Children getChildren() const { return Children(tree, node().firstChild); }
+        uint32_t getIndex() const { return index; }
+
+    private:
+        const Node& node() const { return tree->nodes[index]; }
+
+        const FlatTree* tree;
+        uint32_t index;
+    };
+
+    FlatTree() {}
+    explicit FlatTree(const TreeNode* root) { build(root); }
+
+    void build(const TreeNode* root);
+    void clear() { nodes.clear(); }
+
+    bool empty() const { return nodes.empty(); }
+    uint32_t size() const { return static_cast<uint32_t>(nodes.size()); }
+    const Node& operator[](uint32_t i) const { return nodes[i]; }
+    NodeRef root() const { return NodeRef(*this, 0); }
+
+    // То же, что TreeNode::getMaxLevel для узла index; высоты поддеревьев считаются в build
+    int getMaxLevel(int currentLevel = 1, uint32_t index = 0) const {
+        return currentLevel + static_cast<int>(nodes[index].height);
+    }
+
+    // Тот же текст, что TreeNode::printTree для узла index
+    void printTree(std::ostream& outFile, int maxLevel, int currentLevel = 1, int indentation = 0, uint32_t index = 0) const;
+
+    uint32_t subtreeSize(uint32_t index) const { return nodes[index].end - index; }
+
+    // Одинаковы ли поддеревья a и b (строки, типы и форма). Разные хэши отсекают сразу,
+    // при равных хэшах поддеревья сравниваются узел за узлом.
+    bool sameSubtree(uint32_t a, uint32_t b) const;
+
+    // Группы одинаковых поддеревьев не меньше minNodes узлов, в каждой хотя бы два; группы
+    // в порядке первого вхождения, номера узлов в группе по возрастанию. Вложенные повторы
+    // (например Expr внутри двух одинаковых Op) образуют свои группы.
+    std::vector<std::vector<uint32_t>> groupIdenticalSubtrees(uint32_t minNodes = 1) const;
+
+    // Те же строки, что TreeNode::collectChildStrings для корня
+    std::vector<std::string> collectChildStrings(int indentation = 0) const;
+
+private:
+    std::vector<Node> nodes;
+};
+
+#endif // FLATTREE_H
@@ -0,0 +1,276 @@
+﻿#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+
+// Грамматика для построения дерева операторов и LL(1)-таблица разбора по ней. Правила записаны
+// один раз в rules ниже, множества FIRST/FOLLOW и таблица предсказаний строятся на этапе
+// компиляции; static_assert не даст собрать программу, если правка грамматики нарушит LL(1).
+// Действия (A_*) - вставки в правые части правил: разбор выполняет их, когда доходит до них,
+// и так строит узлы дерева (см. Parser.cpp).
+// Таблица не проверяет программу и не выдаёт сообщений: по ней разбираются только операторы,
+// уже принятые проверками SintaksisAnalyzer (is_cycle, isValidOperator, is_descriptions,
+// is_start_program, is_end_program), а порядок операторов в программе
+// (Program -> Begin Descriptions Operators End) проверяет SintaksisAnalyzer::check_error.
+// Правила здесь должны принимать всё, что принимают эти проверки.
+namespace Grammar {
+
+    // Терминалы - классы слов оператора
+    enum Terminal : uint8_t {
+        T_PROGRAM, T_END, T_INTEGER, T_FOR, T_TO, T_DO,
+        T_ID,      // слово, начинающееся с буквы
+        T_CONST,   // слово, начинающееся с цифры
+        T_ASSIGN,  // =
+        T_SIGN,    // + -
+        T_STAR,    // *
+        T_LPAREN, T_RPAREN, T_COMMA,
+        T_OTHER,   // всё остальное
+        T_NEXT,    // граница присваиваний в теле цикла, вставляется при разборе
+        T_EOS,     // конец оператора
+        TERMINAL_COUNT
+    };
+
+    enum NonTerminal : uint8_t {
+        N_START,        // Begin -> PROGRAM Id
+        N_END,          // End -> END Id
+        N_DESCRIPTIONS, // Descr -> INTEGER VarList
+        N_VARLIST,
+        N_OPERATOR,     // Op -> Id = Expr
+        N_OPERAND,
+        N_OPERATION,
+        N_CYCLE_STATEMENT,
+        N_CYCLE,        // FOR Expr TO Expr DO Operators
+        N_HEADER,
+        N_BOUND,
+        N_BODY,
+        N_ASSIGNMENTS,
+        N_MORE_ASSIGNMENTS,
+        N_ASSIGNMENT,
+        N_BODY_OPERAND,
+        N_BODY_OPERATION,
+        NONTERMINAL_COUNT
+    };
+
+    enum Action : uint8_t {
+        A_KEYWORD, A_NAME,
+        A_DESCR, A_VAR, A_SEPARATOR,
+        A_LHS, A_ASSIGN, A_OPEN, A_CLOSE, A_OPERAND, A_OPERATION,
+        A_FOR, A_HEADER_ASSIGN, A_HEADER_OPERATION, A_HEADER_OPERAND,
+        A_TO, A_BOUND_OPEN, A_BOUND_CLOSE, A_BOUND_OPERATION, A_BOUND_OPERAND,
+        A_DO, A_SPLIT, A_NEW_OP, A_BODY_OPERAND, A_BODY_OPERATION
+    };
+
+    using TerminalSet = uint32_t;
+
+    constexpr TerminalSet bit(Terminal t) { return TerminalSet(1) << t; }
+    constexpr TerminalSet set(std::initializer_list<Terminal> terminals) {
+        TerminalSet result = 0;
+        for (Terminal t : terminals) result |= bit(t);
+        return result;
+    }
+
+    constexpr TerminalSet WORD = bit(T_NEXT) - 1; // любое слово: всё, кроме T_NEXT и T_EOS
+    constexpr TerminalSet KEYWORDS = set({ T_PROGRAM, T_END, T_INTEGER, T_FOR, T_TO, T_DO });
+    constexpr TerminalSet VALUE = KEYWORDS | set({ T_ID, T_CONST, T_OTHER }); // операнд выражения
+
+    struct Symbol {
+        enum Kind : uint8_t { TERMINALS, NONTERMINAL, ACTION } kind;
+        uint8_t value;        // NonTerminal или Action
+        TerminalSet terminals; // для TERMINALS: допустимые на этом месте классы слов
+    };
+
+    constexpr Symbol t(TerminalSet terminals) { return { Symbol::TERMINALS, 0, terminals }; }
+    constexpr Symbol n(NonTerminal nonTerminal) { return { Symbol::NONTERMINAL, nonTerminal, 0 }; }
+    constexpr Symbol a(Action action) { return { Symbol::ACTION, action, 0 }; }
+
+    constexpr int MAX_RHS = 9;
+
+    struct Rule {
+        NonTerminal lhs;
+        uint8_t length;
+        std::array<Symbol, MAX_RHS> rhs;
+    };
+
+    constexpr Rule rule(NonTerminal lhs, std::initializer_list<Symbol> rhs) {
+        Rule result{ lhs, 0, {} };
+        for (const Symbol& symbol : rhs) result.rhs[result.length++] = symbol;
+        return result;
+    }
+
+    constexpr Rule rules[] = {
+        rule(N_START, { t(bit(T_PROGRAM)), a(A_KEYWORD), t(WORD), a(A_NAME), t(bit(T_EOS)) }),
+        rule(N_END, { t(bit(T_END)), a(A_KEYWORD), t(WORD), a(A_NAME), t(bit(T_EOS)) }),
+
+        rule(N_DESCRIPTIONS, { t(bit(T_INTEGER)), a(A_DESCR), n(N_VARLIST), t(bit(T_EOS)) }),
+        rule(N_VARLIST, { t(bit(T_COMMA)), a(A_SEPARATOR), n(N_VARLIST) }),
+        rule(N_VARLIST, { t(WORD & ~bit(T_COMMA)), a(A_VAR), n(N_VARLIST) }),
+        rule(N_VARLIST, {}),
+
+        // Скобки допускаются в любом месте выражения
+        rule(N_OPERATOR, { t(VALUE), a(A_LHS), t(bit(T_ASSIGN)), a(A_ASSIGN), n(N_OPERAND), t(bit(T_EOS)) }),
+        rule(N_OPERAND, { t(bit(T_LPAREN)), a(A_OPEN), n(N_OPERAND) }),
+        rule(N_OPERAND, { t(bit(T_RPAREN)), a(A_CLOSE), n(N_OPERAND) }),
+        rule(N_OPERAND, { t(VALUE), a(A_OPERAND), n(N_OPERATION) }),
+        rule(N_OPERATION, { t(bit(T_LPAREN)), a(A_OPEN), n(N_OPERATION) }),
+        rule(N_OPERATION, { t(bit(T_RPAREN)), a(A_CLOSE), n(N_OPERATION) }),
+        rule(N_OPERATION, { t(bit(T_SIGN)), a(A_OPERATION), n(N_OPERAND) }),
+        rule(N_OPERATION, {}),
+
+        rule(N_CYCLE_STATEMENT, { n(N_CYCLE), t(bit(T_EOS)) }),
+        rule(N_CYCLE, { t(bit(T_FOR)), a(A_FOR), n(N_HEADER), t(bit(T_TO)), a(A_TO), n(N_BOUND),
+            t(bit(T_DO)), a(A_DO), n(N_BODY) }),
+        rule(N_HEADER, { t(bit(T_ASSIGN)), a(A_HEADER_ASSIGN), n(N_HEADER) }),
+        rule(N_HEADER, { t(set({ T_SIGN, T_STAR })), a(A_HEADER_OPERATION), n(N_HEADER) }),
+        rule(N_HEADER, { t(WORD & ~set({ T_ASSIGN, T_SIGN, T_STAR, T_TO })), a(A_HEADER_OPERAND), n(N_HEADER) }),
+        rule(N_HEADER, {}),
+        rule(N_BOUND, { t(bit(T_LPAREN)), a(A_BOUND_OPEN), n(N_BOUND) }),
+        rule(N_BOUND, { t(bit(T_RPAREN)), a(A_BOUND_CLOSE), n(N_BOUND) }),
+        rule(N_BOUND, { t(set({ T_SIGN, T_ASSIGN })), a(A_BOUND_OPERATION), n(N_BOUND) }),
+        rule(N_BOUND, { t(WORD & ~set({ T_LPAREN, T_RPAREN, T_SIGN, T_ASSIGN, T_DO })), a(A_BOUND_OPERAND), n(N_BOUND) }),
+        rule(N_BOUND, {}),
+
+        // Тело цикла - вложенный цикл до конца оператора или присваивания подряд
+        rule(N_BODY, { n(N_CYCLE) }),
+        rule(N_BODY, { a(A_SPLIT), n(N_ASSIGNMENTS) }),
+        rule(N_BODY, {}),
+        rule(N_ASSIGNMENTS, { n(N_ASSIGNMENT), n(N_MORE_ASSIGNMENTS) }),
+        rule(N_MORE_ASSIGNMENTS, { t(bit(T_NEXT)), n(N_ASSIGNMENT), n(N_MORE_ASSIGNMENTS) }),
+        rule(N_MORE_ASSIGNMENTS, {}),
+        rule(N_ASSIGNMENT, { a(A_NEW_OP), t(WORD & ~bit(T_FOR)), a(A_BODY_OPERAND), n(N_BODY_OPERATION) }),
+        rule(N_BODY_OPERATION, { t(WORD), a(A_BODY_OPERATION), n(N_BODY_OPERAND) }),
+        rule(N_BODY_OPERATION, {}),
+        rule(N_BODY_OPERAND, { t(WORD), a(A_BODY_OPERAND), n(N_BODY_OPERATION) }),
+        rule(N_BODY_OPERAND, {}),
+    };
+
+    constexpr int RULE_COUNT = sizeof(rules) / sizeof(rules[0]);
+    constexpr uint8_t NO_RULE = 0xFF;
+
+    struct Table {
+        std::array<std::array<uint8_t, TERMINAL_COUNT>, NONTERMINAL_COUNT> predict{};
+        bool conflict = false; // две продукции на одну клетку: грамматика не LL(1)
+    };
+
+    struct Sets {
+        std::array<bool, NONTERMINAL_COUNT> nullable{};
+        std::array<TerminalSet, NONTERMINAL_COUNT> first{};
+        std::array<TerminalSet, NONTERMINAL_COUNT> follow{};
+    };
+
+    // FIRST цепочки rhs[from, length); nullable - выводима ли она в пустую
+    constexpr TerminalSet firstOf(const Sets& sets, const Rule& r, int from, bool& nullable) {
+        TerminalSet result = 0;
+        for (int i = from; i < r.length; ++i) {
+            const Symbol& symbol = r.rhs[i];
+            if (symbol.kind == Symbol::TERMINALS) {
+                nullable = false;
+                return result | symbol.terminals;
+            }
+            if (symbol.kind == Symbol::NONTERMINAL) {
+                result |= sets.first[symbol.value];
+                if (!sets.nullable[symbol.value]) {
+                    nullable = false;
+                    return result;
+                }
+            }
+        }
+        nullable = true;
+        return result;
+    }
+
+    constexpr Sets buildSets() {
+        Sets sets{};
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (const Rule& r : rules) {
+                bool nullable = false;
+                TerminalSet first = firstOf(sets, r, 0, nullable);
+                if ((sets.first[r.lhs] | first) != sets.first[r.lhs] || (nullable && !sets.nullable[r.lhs])) {
+                    sets.first[r.lhs] |= first;
+                    sets.nullable[r.lhs] = sets.nullable[r.lhs] || nullable;
+                    changed = true;
+                }
+                for (int i = 0; i < r.length; ++i) {
+                    if (r.rhs[i].kind != Symbol::NONTERMINAL) {
+                        continue;
+                    }
+                    bool restNullable = false;
+                    TerminalSet follow = firstOf(sets, r, i + 1, restNullable);
+                    if (restNullable) {
+                        follow |= sets.follow[r.lhs];
+                    }
+                    TerminalSet& target = sets.follow[r.rhs[i].value];
+                    if ((target | follow) != target) {
+                        target |= follow;
+                        changed = true;
+                    }
+                }
+            }
+        }
+        return sets;
+    }
+
+    constexpr Table buildTable() {
+        Sets sets = buildSets();
+        Table table{};
+        for (auto& row : table.predict) {
+            for (uint8_t& cell : row) cell = NO_RULE;
+        }
+        for (int index = 0; index < RULE_COUNT; ++index) {
+            const Rule& r = rules[index];
+            bool nullable = false;
+            TerminalSet predict = firstOf(sets, r, 0, nullable);
+            if (nullable) {
+                predict |= sets.follow[r.lhs];
+            }
+            for (int terminal = 0; terminal < TERMINAL_COUNT; ++terminal) {
+                if (predict & (TerminalSet(1) << terminal)) {
+                    uint8_t& cell = table.predict[r.lhs][terminal];
+                    table.conflict = table.conflict || cell != NO_RULE;
+                    cell = static_cast<uint8_t>(index);
+                }
+            }
+        }
+        return table;
+    }
+
+    constexpr Table table = buildTable();
+    static_assert(!table.conflict, "statement grammar is not LL(1)");
+
+    // Класс слова: ключевые слова узнаются по длине и первой букве, остальное по первому символу
+    inline Terminal classify(std::string_view word) {
+        switch (word.size()) {
+        case 1:
+            switch (word[0]) {
+            case '=': return T_ASSIGN;
+            case '+': case '-': return T_SIGN;
+            case '*': return T_STAR;
+            case '(': return T_LPAREN;
+            case ')': return T_RPAREN;
+            case ',': return T_COMMA;
+            }
+            break;
+        case 2:
+            if (word == "TO") return T_TO;
+            if (word == "DO") return T_DO;
+            break;
+        case 3:
+            if (word == "END") return T_END;
+            if (word == "FOR") return T_FOR;
+            break;
+        case 7:
+            if (word == "INTEGER") return T_INTEGER;
+            if (word == "PROGRAM") return T_PROGRAM;
+            break;
+        }
+        if (word[0] >= '0' && word[0] <= '9') return T_CONST;
+        if ((word[0] >= 'A' && word[0] <= 'Z') || (word[0] >= 'a' && word[0] <= 'z')) return T_ID;
+        return T_OTHER;
+    }
+
+}
+
+#endif // GRAMMAR_H
@@ -0,0 +1,51 @@
+﻿#include "Interner.h"
+#include "StringTable.h"
+#include <cassert>
+
+namespace {
+
+    struct Table {
+        StringTable strings;
+
+        Table() {
+            static const char* const predefined[] = {
+                "Descriptions", "Descr", "Type", "Varlist", "Operators", "Op",
+                "Expr", "SimpleExpr", "NestedCycle",
+                "WordsKey", "Symbols_of_Operation", "Symbols_of_Separating", "Const",
+                "Opening_Bracket", "Closing_Bracket", "Id",
+                "Program",
+                "PROGRAM", "END", "FOR", "TO", "DO",
+                "=", "+", "-", "*", "/",
+                "(", ")", ","
+            };
+            static_assert(sizeof(predefined) / sizeof(predefined[0]) == Interner::PREDEFINED_COUNT,
+                "predefined symbols do not match Interner constants");
+            for (const char* text : predefined) {
+                strings.intern(text);
+            }
+            assert(strings.size() == Interner::PREDEFINED_COUNT);
+        }
+    };
+
+    Table& table() {
+        static Table instance;
+        return instance;
+    }
+
+}
+
+Interner::Symbol Interner::intern(std::string_view text) {
+    return table().strings.intern(text);
+}
+
+Interner::Symbol Interner::lookup(std::string_view text) {
+    return table().strings.find(text);
+}
+
+std::string_view Interner::text(Symbol symbol) {
+    return table().strings.text(symbol);
+}
+
+Interner::Symbol Interner::size() {
+    return table().strings.size();
+}
@@ -0,0 +1,45 @@
+﻿#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <cstdint>
+#include <string_view>
+
+// Общая для TokenList, Parser и TreeNode таблица строк (StringTable): каждая строка хранится
+// один раз, токен и узел дерева держат только её номер, и строки сравниваются сравнением
+// номеров. Текст строк не перемещается, string_view из text() действительны до конца программы.
+// Служебные метки и слова, которые проверяют обходы дерева, получают постоянные номера
+// ниже: они вносятся в таблицу первыми, до любых строк из токенов.
+// Таблица символов TokenList хранит номера отсюда, и слова дерева получают номер из токена,
+// а не повторным поиском текста.
+// Таблица одна на процесс и не потокобезопасна: деревья строятся в одном потоке.
+class Interner {
+public:
+    using Symbol = uint32_t;
+
+    enum : Symbol {
+        // Метки, которые не попадают в строки операторов (FlatTree::collectChildStrings)
+        LABEL_DESCRIPTIONS, LABEL_DESCR, LABEL_TYPE, LABEL_VARLIST, LABEL_OPERATORS, LABEL_OP,
+        LABEL_EXPR, LABEL_SIMPLE_EXPR, LABEL_NESTED_CYCLE,
+        LABEL_WORDS_KEY, LABEL_OPERATION, LABEL_SEPARATING, LABEL_CONST,
+        LABEL_OPENING_BRACKET, LABEL_CLOSING_BRACKET, LABEL_ID,
+        SERVICE_LABEL_END,
+        LABEL_PROGRAM = SERVICE_LABEL_END,
+        // Слова, которые проверка переменных не считает идентификаторами
+        WORD_PROGRAM, WORD_END, WORD_FOR, WORD_TO, WORD_DO,
+        WORD_ASSIGN, WORD_PLUS, WORD_MINUS, WORD_STAR, WORD_SLASH,
+        WORD_LPAREN, WORD_RPAREN, WORD_COMMA,
+        PREDEFINED_COUNT
+    };
+
+    static constexpr Symbol NOT_FOUND = 0xFFFFFFFFu; // то же, что StringTable::NOT_FOUND
+
+    static Symbol intern(std::string_view text);
+    static Symbol lookup(std::string_view text); // NOT_FOUND, если строки в таблице нет; таблица не растёт
+    static std::string_view text(Symbol symbol);
+    static Symbol size();
+
+    static bool isServiceLabel(Symbol symbol) { return symbol < SERVICE_LABEL_END; }
+    static bool isIgnoredWord(Symbol symbol) { return symbol >= WORD_PROGRAM && symbol <= WORD_COMMA; }
+};
+
+#endif // INTERNER_H
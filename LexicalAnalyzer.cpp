@@ -1,15 +1,35 @@
 #include "LexicalAnalyzer.h"
 #include "Token.h"
 #include "SintaksisAnalyzer.h"
+#include "CharScanner.h"
+#include "ParallelLexer.h"
+#include "Trace.h"
 #include <iostream>
+#include <cstring>
 
 LexicalAnalyzer::LexicalAnalyzer(const std::string& inputFileName, const std::string& outputFileName) {
-    inputFile.open(inputFileName);
+    source.open(inputFileName);
+    cursor = source.begin();
+    previousCursor = cursor;
+    sourceEnd = source.end();
+    tokenList.setSource(cursor, sourceEnd);
+    lineIndex.build(cursor, sourceEnd);
     outputFile.open(outputFileName);
+    sintaksis_analyzer.open_files();
+}
+
+LexicalAnalyzer::LexicalAnalyzer(const std::string& inputFileName) {
+    source.open(inputFileName);
+    cursor = source.begin();
+    previousCursor = cursor;
+    sourceEnd = source.end();
+    tokenList.setSource(cursor, sourceEnd);
+    lineIndex.build(cursor, sourceEnd);
+    syntaxEnabled = false;
 }
 
 
-bool LexicalAnalyzer::isValidIdentifier(const std::string& word) const {
+bool LexicalAnalyzer::isValidIdentifier(std::string_view word) const {
     // ,           
     for (char c : word) {
         if (!isalpha(c)) { //     
@@ -20,16 +40,57 @@ bool LexicalAnalyzer::isValidIdentifier(const std::string& word) const {
 }
 
 
-LexicalAnalyzer::~LexicalAnalyzer() {
-    if (inputFile.is_open()) {
-        inputFile.close();
+bool LexicalAnalyzer::readWord(std::string_view& word) {
+    char c;
+    //     
+    do {
+        if (!getChar(c)) {
+            return false;
+        }
+    } while (isspace(c));
+
+    const char* start = previousCursor;
+    while (cursor != sourceEnd && !isspace(*cursor)) {
+        ++cursor;
+    }
+    word = std::string_view(start, cursor - start);
+    return true;
+}
+
+
+std::string_view LexicalAnalyzer::readErrorTail(const char* start, bool inputEnded) {
+    if (inputEnded) {
+        //     :   ,     
+        syntheticLexeme.assign(start, cursor);
+        syntheticLexeme += cursor[-1];
+        return syntheticLexeme;
+    }
+    const char* stop = cursor;
+    char c;
+    while (getChar(c) && !isspace(c) && c != EOF) {
+        stop = cursor;
     }
+    std::string_view word(start, stop - start);
+#ifdef _WIN32
+    //         ; "\r\n"     '\n'
+    size_t crlf = word.find("\r\n");
+    if (crlf != std::string_view::npos) {
+        syntheticLexeme.assign(word.data(), crlf);
+        syntheticLexeme.append(word.data() + crlf + 1, word.size() - crlf - 1);
+        return syntheticLexeme;
+    }
+#endif
+    return word;
+}
+
+
+LexicalAnalyzer::~LexicalAnalyzer() {
     if (outputFile.is_open()) {
         outputFile.close();
     }
 }
 
-TokenType LexicalAnalyzer::getKeywordOrIdentifier(const std::string& lexeme) {
+TokenType LexicalAnalyzer::getKeywordOrIdentifier(std::string_view lexeme) {
     const char* keywords[] = { "INTEGER", "DO", "TO", "FOR"};
     TokenType keywordTokens[] = {
         TokenType::TYPE,
@@ -67,7 +128,7 @@ TokenType LexicalAnalyzer::getKeywordOrIdentifier(const std::string& lexeme) {
 }
 
 
-TokenType LexicalAnalyzer::getNumber(const std::string& lexeme) {
+TokenType LexicalAnalyzer::getNumber(std::string_view lexeme) {
     // ,     
     for (char c : lexeme) {
         if (!isdigit(c)) {
@@ -87,138 +148,141 @@ void LexicalAnalyzer::handleDelimiters(char c) {
 }
 
 Token LexicalAnalyzer::getNextLexeme() {
-    std::string word;
     char c;
     int index = 1;
     bool lastWasOperator = false;
-    while (inputFile.get(c)) {
+    while (getChar(c)) {
+        const char* start = previousCursor; //      
+        TRACE(LEXER, 3, "Current Column: %u, Current Char: %c", index, c);
         if (c == '\n' || c == '\r' || c =='\n\r') {
-            tokenList.addToken(Token(TokenType::END_LINE, "END_LINE", index));
+            tokenList.addToken(Token(TokenType::END_LINE, "END_LINE", index, start));
             count_line++;
-            if (!lexeme.empty() && lexeme != "\n") {
+            TRACE(LEXER, 1, "Line %u: %u tokens so far", count_line, tokenList.getTokenCount());
+            if (syntaxEnabled && !lexeme.empty() && lexeme != "\n") {
                 sintaksis_analyzer.trim(lexeme);
-                sintaksis_analyzer.building_tree(count_line, lexeme);
+                //  ,   :       
+                int line = lineIndex.lineOf(tokenList.getStream().getOffset(statementToken));
+                sintaksis_analyzer.building_tree(line, lexeme, tokenList, statementToken, tokenList.getTokenCount());
             }
-            lexeme = "";
+            lexeme.clear();
+            statementToken = tokenList.getTokenCount();
         }
         if (isspace(c)) {
-            index++;
-            lexeme += " ";
+            //        
+            size_t run = CharScanner::spaceRun(cursor, sourceEnd);
+            cursor += run;
+            index += 1 + static_cast<int>(run);
+            lexeme.append(1 + run, ' ');
             continue;
         }
         if (isalpha(c)) { //    
-            word.clear();
             if (c == 'P') {  //    "PROGRAM"
                 std::string programWord = "PROGRAM";
                 bool isProgram = true;
-                std::string potential_error;
+                bool inputEnded = false; //    :   ,  
 
                 for (size_t i = 1; i < programWord.length(); i++) {
-                    potential_error += c;
-                    if (!inputFile.get(c) || c != programWord[i]) {
+                    if (!getChar(c)) {
+                        inputEnded = true;
+                        isProgram = false;
+                        break;
+                    }
+                    if (c != programWord[i]) {
                         isProgram = false;
                         break;
                     }
                 }
 
                 if (isProgram) {  //   "PROGRAM"  
-                    inputFile.get(c);  //      "PROGRAM"
+                    inputEnded = !getChar(c);  //      "PROGRAM"
                     if (isspace(c) || c == ':' || c == EOF) {  //   ,    
-                        std::string id;
-                        if (inputFile >> id && isValidIdentifier(id)) {
-                            tokenList.addToken(Token(TokenType::PROGRAM, "PROGRAM", index));
+                        std::string_view id;
+                        if (readWord(id) && isValidIdentifier(id)) {
+                            tokenList.addToken(Token(TokenType::PROGRAM, std::string_view(start, programWord.length()), index));
                             Token nextToken = Token(TokenType::BEGIN, id, index + 1);
-                            lexeme += "PROGRAM " + id;
+                            lexeme += "PROGRAM ";
+                            lexeme += id;
                             return nextToken;
                         }
                         else {
                             lexeme += id;
-                            return Token(TokenType::ERROR, id, index);  // ,   
+                            return Token(TokenType::ERROR, id, index, start);  // ,   
                         }
                     }
                     else {
-                        std::string errorWord = "PROGRAM" + std::string(1, c);  //    
-
-                        //         
-                        while (inputFile.get(c) && !isspace(c) && c != EOF) {
-                            errorWord += c;
-                        }
+                        //    "PROGRAM"     
+                        std::string_view errorWord = readErrorTail(start, inputEnded);
                         lexeme += errorWord;
-                        return Token(TokenType::ERROR, errorWord, index);  //      
+                        return Token(TokenType::ERROR, errorWord, index, start);  //      
                     }
 
                 }
                 else {
-                    potential_error += c;
                     //    
-                    while (inputFile.get(c) && !isspace(c) && c != EOF) {
-                        potential_error += c;
-                    }
+                    std::string_view potential_error = readErrorTail(start, inputEnded);
                     if (isValidIdentifier(potential_error)) {
                         lexeme += potential_error;
-                        return Token(TokenType::ID_NAME, potential_error, index);
+                        return Token(TokenType::ID_NAME, potential_error, index, start);
                     }
                     lexeme += potential_error;
-                    return Token(TokenType::ERROR, potential_error, index);  //      
+                    return Token(TokenType::ERROR, potential_error, index, start);  //      
                 }
             }
 
             if (c == 'E') {  //    "END"
                 std::string endWord = "END";
                 bool isEnd = true;
-                std::string potential_error;
+                bool inputEnded = false;
 
                 //    "END"
                 for (size_t i = 1; i < endWord.length(); i++) {
-                    potential_error += c;
-                    if (!inputFile.get(c) || c != endWord[i]) {
+                    if (!getChar(c)) {
+                        inputEnded = true;
+                        isEnd = false;
+                        break;
+                    }
+                    if (c != endWord[i]) {
                         isEnd = false;
                         break;
                     }
                 }
 
                 if (isEnd) {  //   "END"  
-                    inputFile.get(c);  //   
+                    inputEnded = !getChar(c);  //   
                     if (isspace(c) || c == ':' || c == EOF) {  //   ,    
-                        tokenList.addToken(Token(TokenType::END, "END", index));  //   END
+                        std::string_view end(start, endWord.length());
+                        tokenList.addToken(Token(TokenType::END, end, index));  //   END
                         lexeme += "END ";
-                        return Token(TokenType::END, "END", index);  //   END
+                        return Token(TokenType::END, end, index);  //   END
                     }
                     else {
-                        std::string errorWord = "END " + std::string(1, c);  //    
-
-                        //         
-                        while (inputFile.get(c) && !isspace(c) && c != EOF) {
-                            errorWord += c;
-                        }
-
-                        lexeme += errorWord;
-                        return Token(TokenType::ERROR, errorWord, index);  //      
+                        //  "END"  ,        
+                        std::string_view tail = readErrorTail(start + endWord.length(), inputEnded);
+                        syntheticLexeme = "END " + std::string(tail);
+                        lexeme += syntheticLexeme;
+                        return Token(TokenType::ERROR, syntheticLexeme, index, start);  //      
                     }
                 }
                 else {
-                    potential_error += c;
                     //    
-                    while (inputFile.get(c) && !isspace(c) && c != EOF) {
-                        potential_error += c;
-                    }
+                    std::string_view potential_error = readErrorTail(start, inputEnded);
 
                     if (isValidIdentifier(potential_error)) {
                         lexeme += potential_error;
-                        return Token(TokenType::ID_NAME, potential_error, index);
+                        return Token(TokenType::ID_NAME, potential_error, index, start);
                     }
 
                     lexeme += potential_error;
-                    return Token(TokenType::ERROR, potential_error, index);  //      
+                    return Token(TokenType::ERROR, potential_error, index, start);  //      
                 }
             }
 
 
-            word += c;
-            while (inputFile.get(c) && (isalnum(c) || c == '_')) {
-                word += c;
+            cursor += CharScanner::identRun(cursor, sourceEnd); //   
+            while (getChar(c) && (isalnum(c) || c == '_')) {
             }
-            inputFile.unget(); //     
+            ungetChar(); //     
+            std::string_view word(start, cursor - start);
 
 
 
@@ -234,12 +298,11 @@ Token LexicalAnalyzer::getNextLexeme() {
             }
         }
         else if (isdigit(c)) { //   
-            word.clear();
-            word += c;
-            while (inputFile.get(c) && (isalnum(c) || c == '_')) {
-                word += c;
+            cursor += CharScanner::identRun(cursor, sourceEnd); //   
+            while (getChar(c) && (isalnum(c) || c == '_')) {
             }
-            inputFile.unget(); //     
+            ungetChar(); //     
+            std::string_view word(start, cursor - start);
             for (int j = 0; j < word.size(); j++) {
                 if (!isdigit(word[j])) {
                     lexeme += word;
@@ -256,34 +319,32 @@ Token LexicalAnalyzer::getNextLexeme() {
 
         else if (c == '=' || c == '+' || c == '-') {  // 
             if (lastWasOperator) {
-                return Token(TokenType::ERROR, "Consecutive operators", index);  //    ,  
+                return Token(TokenType::ERROR, "Consecutive operators", index, start);  //    ,  
             }
             lastWasOperator = true;  //  ,     
-            word = c;
 
-            if (inputFile.peek() == c && (c == '+' || c == '-')) {  //   ++  --
-                inputFile.get();  //   
-                word += c;
+            if (peekChar() == c && (c == '+' || c == '-')) {  //   ++  --
+                getChar(c);  //   
+                std::string_view word(start, 2);
                 lexeme += word;
                 return Token(TokenType::ERROR, word, index);  //    ++  --
             }
+            std::string_view word(start, 1);
             lexeme += word;
             return Token(TokenType::OPERATOR, word, index);  //  
         }
 
         else if (isDelimiter(c)) { // 
-            lexeme += std::string(1, c);
-            return Token(TokenType::DELIMITER, std::string(1, c), index);
+            lexeme += c;
+            return Token(TokenType::DELIMITER, std::string_view(start, 1), index);
         }
 
         else {
             //    ,    
-            word.clear();
-            word += c;
-            while (inputFile.get(c) && !isspace(c) && !isDelimiter(c)) {
-                word += c;
+            while (getChar(c) && !isspace(c) && !isDelimiter(c)) {
             }
-            inputFile.unget(); //    
+            ungetChar(); //    
+            std::string_view word(start, cursor - start);
             lexeme += word;
             return Token(TokenType::ERROR, word, index);
         }
@@ -295,6 +356,43 @@ Token LexicalAnalyzer::getNextLexeme() {
 
 
 
+void LexicalAnalyzer::tokenize() {
+    syntaxEnabled = false;
+    Token token;
+    while ((token = getNextLexeme()).type != TokenType::UNKNOWN) {
+        tokenList.addToken(token);
+    }
+}
+
+
+void LexicalAnalyzer::tokenizeParallel(unsigned threadCount) {
+    syntaxEnabled = false;
+    count_line += ParallelLexer(threadCount).tokenize(cursor, sourceEnd, tokenList);
+    cursor = sourceEnd;
+}
+
+
+//   ,   analyze,      ,  
+//   ;         
+bool LexicalAnalyzer::check() {
+    syntaxEnabled = true;
+    sintaksis_analyzer.set_check_only(true);
+    try {
+        Token token;
+        while ((token = getNextLexeme()).type != TokenType::UNKNOWN) {
+            tokenList.addToken(token);
+        }
+        int tokenCount = tokenList.getTokenCount();
+        int lastLine = tokenCount > 0 ? lineIndex.lineOf(tokenList.getStream().getOffset(tokenCount - 1)) : 1;
+        sintaksis_analyzer.check_error(lastLine);
+    }
+    catch (const std::ios_base::failure&) {
+        return false; //     
+    }
+    return !sintaksis_analyzer.has_errors() && sintaksis_analyzer.check_semantics();
+}
+
+
 void LexicalAnalyzer::analyze() {
     Token token;
     while ((token = getNextLexeme()).type != TokenType::UNKNOWN) {
@@ -307,7 +405,10 @@ void LexicalAnalyzer::analyze() {
 
     tokenList.printTokens(outputFile);
 
-    sintaksis_analyzer.check_error();
+    //      
+    int tokenCount = tokenList.getTokenCount();
+    int lastLine = tokenCount > 0 ? lineIndex.lineOf(tokenList.getStream().getOffset(tokenCount - 1)) : 1;
+    sintaksis_analyzer.check_error(lastLine);
     sintaksis_analyzer.Printing_Tree();
     sintaksis_analyzer.analyzeTree();
     sintaksis_analyzer.printCollectedStrings();
@@ -7,34 +7,81 @@
 #include "TokenList.h"
 #include "SintaksisAnalyzer.h"
 #include "TreeNode.h"
+#include "SourceBuffer.h"
+#include "LineIndex.h"
 
 class LexicalAnalyzer {
 public:
     SintaksisAnalyzer sintaksis_analyzer;
-    std::string lexeme;
+    std::string lexeme; //      SintaksisAnalyzer (   )
     int count_line = 0;
     int count = 0;
     LexicalAnalyzer(const std::string& inputFileName, const std::string& outputFileName);
+    explicit LexicalAnalyzer(const std::string& inputFileName); //   ,   
     ~LexicalAnalyzer();
     void analyze();
+    bool check(); //   :       ; false  
+    void tokenize(); //     tokenList,      
+    void tokenizeParallel(unsigned threadCount = 0); //    ParallelLexer (0  -   )
 
     TokenList& getTokenList() {
         return tokenList;
     }
+    const LineIndex& getLineIndex() const {
+        return lineIndex;
+    }
 
 private:
-    std::ifstream inputFile;
+    SourceBuffer source;          //     
+    LineIndex lineIndex;          //   source
+    int statementToken = 0;       //   ,   lexeme
+    const char* cursor = nullptr; //   
+    const char* previousCursor = nullptr;
+    const char* sourceEnd = nullptr;
+    bool inputFailed = false;     //  failbit  :       
+    bool syntaxEnabled = true;    //      sintaksis_analyzer
+    std::string syntheticLexeme;  // ,     ( "END x");    getNextLexeme
     std::ofstream outputFile;
     TokenList tokenList;
     const std::string tree = "parsing_tree.txt";
 
+    //       get/unget/peek  std::ifstream
+    bool getChar(char& c) {
+        if (inputFailed || cursor == sourceEnd) {
+            inputFailed = true;
+            return false;
+        }
+        previousCursor = cursor;
+        c = *cursor++;
+#ifdef _WIN32
+        //   ifstream  "\r\n"  '\n'
+        if (c == '\r' && cursor != sourceEnd && *cursor == '\n') {
+            c = *cursor++;
+        }
+#endif
+        return true;
+    }
+    void ungetChar() {
+        if (!inputFailed) {
+            cursor = previousCursor;
+        }
+    }
+    int peekChar() const {
+        if (inputFailed || cursor == sourceEnd) {
+            return EOF;
+        }
+        return std::char_traits<char>::to_int_type(*cursor);
+    }
+    bool readWord(std::string_view& word); //  inputFile >> word,     
+    std::string_view readErrorTail(const char* start, bool inputEnded); //    start  
+
     Token getNextLexeme();
-    TokenType getKeywordOrIdentifier(const std::string& lexeme);
-    TokenType getNumber(const std::string& lexeme);
+    TokenType getKeywordOrIdentifier(std::string_view lexeme);
+    TokenType getNumber(std::string_view lexeme);
     bool isOperator(const std::string& str) const;
     bool isDelimiter(char c) const;
     void handleDelimiters(char c);
-    bool isValidIdentifier(const std::string& word) const; //  
+    bool isValidIdentifier(std::string_view word) const; //  
 };
 
 #endif // LEXICALANALYZER_H
@@ -0,0 +1,16 @@
+﻿#include "LineIndex.h"
+#include "CharScanner.h"
+#include <algorithm>
+
+void LineIndex::build(const char* begin, const char* end) {
+    lineStarts.clear();
+    lineStarts.push_back(0);
+    CharScanner::newlineEnds(begin, end, lineStarts);
+}
+
+LineIndex::Position LineIndex::locate(uint32_t offset) const {
+    // Последнее начало строки, не превосходящее offset
+    auto next = std::upper_bound(lineStarts.begin(), lineStarts.end(), offset);
+    int line = static_cast<int>(next - lineStarts.begin());
+    return { line, static_cast<int>(offset - lineStarts[line - 1]) + 1 };
+}
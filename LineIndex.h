@@ -0,0 +1,29 @@
+﻿#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Таблица начал строк исходного текста. Токен хранит только 32-битное смещение,
+// номер строки и столбец по нему находятся двоичным поиском, когда они нужны
+// (диагностика, инструменты). Строки разделяются символом '\n', нумерация с 1.
+class LineIndex {
+public:
+    struct Position {
+        int line;
+        int column;
+    };
+
+    void build(const char* begin, const char* end); // переводы строк ищутся CharScanner::newlineEnds
+
+    Position locate(uint32_t offset) const;
+    int lineOf(uint32_t offset) const { return locate(offset).line; }
+    int lineCount() const { return static_cast<int>(lineStarts.size()); }
+    uint32_t lineStart(int line) const { return lineStarts[line - 1]; }
+
+private:
+    std::vector<uint32_t> lineStarts = { 0 };
+};
+
+#endif // LINEINDEX_H
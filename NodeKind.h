@@ -0,0 +1,27 @@
+﻿#ifndef NODEKIND_H
+#define NODEKIND_H
+
+#include <cstdint>
+
+// Тип узла дерева разбора (то, что печатается в [скобках] в parsing_tree.txt).
+// У служебных узлов (Program, Operators, Expr, ...) типа нет.
+enum class NodeKind : uint8_t {
+    NONE,
+    WORDS_KEY,       // ключевое слово
+    ID,
+    CONST,
+    OPERATION,       // = + - *
+    SEPARATING,      // ,
+    OPENING_BRACKET,
+    CLOSING_BRACKET,
+};
+
+inline const char* nodeKindName(NodeKind kind) {
+    static const char* const names[] = {
+        "", "WordsKey", "Id", "Const", "Symbols_of_Operation", "Symbols_of_Separating",
+        "Opening_Bracket", "Closing_Bracket"
+    };
+    return names[static_cast<int>(kind)];
+}
+
+#endif // NODEKIND_H
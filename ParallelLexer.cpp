@@ -0,0 +1,156 @@
+﻿#include "ParallelLexer.h"
+#include "DfaLexer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // Результат разбора одной части: токены, их символы в таблицах части и начало каждого
+    // шага лексера внутри части. По началам шагов склейка находит место, с которого
+    // последовательный разбор совпадает с разбором части.
+    struct Chunk {
+        const char* begin = nullptr;
+        const char* end = nullptr;
+        const char* stop = nullptr;          // позиция лексера после последнего шага
+        TokenStream tokens;
+        StringTable strings;                 // лексемы части
+        SymbolTable symbols;                 // символы части, строки - номера в strings
+        std::vector<int> tokenSymbols;       // символ каждого токена в symbols
+        std::vector<const char*> stepStarts; // по возрастанию
+        std::vector<int> stepTokens;         // tokens.size() перед каждым шагом
+    };
+
+    // Шаги начинаются внутри [begin, end), последний может выйти за end:
+    // лексер видит весь вход, поэтому токен на стыке разбирается как при последовательном проходе
+    void lexChunk(Chunk& chunk, const char* inputEnd) {
+        DfaLexer lexer(chunk.begin, inputEnd);
+        chunk.tokens.setSource(chunk.begin, inputEnd);
+        while (lexer.position() < chunk.end) {
+            chunk.stepStarts.push_back(lexer.position());
+            chunk.stepTokens.push_back(chunk.tokens.size());
+            if (!lexer.next(chunk.tokens)) {
+                break;
+            }
+        }
+        chunk.stop = lexer.position();
+
+        // Символы ищутся в потоке части; при склейке общая таблица видит каждый символ части один раз
+        chunk.tokenSymbols.reserve(chunk.tokens.size());
+        for (int i = 0; i < chunk.tokens.size(); ++i) {
+            uint32_t name = chunk.strings.intern(chunk.tokens.getLexeme(i));
+            chunk.tokenSymbols.push_back(chunk.symbols.intern(name, chunk.tokens.getType(i)));
+        }
+    }
+
+    // Номер шага части, начинающегося ровно в position, или -1
+    long findStep(const Chunk& chunk, const char* position) {
+        auto it = std::lower_bound(chunk.stepStarts.begin(), chunk.stepStarts.end(), position);
+        if (it == chunk.stepStarts.end() || *it != position) {
+            return -1;
+        }
+        return static_cast<long>(it - chunk.stepStarts.begin());
+    }
+
+}
+
+ParallelLexer::ParallelLexer(unsigned threadCount, size_t minChunkSize)
+    : threadCount(threadCount), minChunkSize(minChunkSize ? minChunkSize : 1) {
+    if (this->threadCount == 0) {
+        this->threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+int ParallelLexer::tokenize(const char* begin, const char* end, TokenList& tokens) {
+    // Несколько частей на поток, чтобы потоки не простаивали на неравных частях
+    size_t size = static_cast<size_t>(end - begin);
+    size_t chunkCount = std::max<size_t>(1, std::min<size_t>(size / minChunkSize, threadCount * 4u));
+    size_t chunkSize = size / chunkCount + 1;
+
+    std::vector<Chunk> chunks;
+    const char* chunkBegin = begin;
+    while (chunkBegin != end) {
+        const char* chunkEnd = end;
+        if (static_cast<size_t>(end - chunkBegin) > chunkSize) {
+            const void* newline = std::memchr(chunkBegin + chunkSize, '\n', static_cast<size_t>(end - chunkBegin - chunkSize));
+            chunkEnd = newline ? static_cast<const char*>(newline) + 1 : end;
+        }
+        chunks.emplace_back();
+        chunks.back().begin = chunkBegin;
+        chunks.back().end = chunkEnd;
+        chunkBegin = chunkEnd;
+    }
+
+    std::atomic<size_t> nextChunk(0);
+    auto worker = [&]() {
+        for (size_t i; (i = nextChunk++) < chunks.size();) {
+            lexChunk(chunks[i], end);
+        }
+    };
+    unsigned workerCount = static_cast<unsigned>(std::min<size_t>(threadCount, chunks.size()));
+    std::vector<std::thread> workers;
+    for (unsigned i = 1; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+
+    // Склейка: position - где находился бы последовательный лексер. Токены частей
+    // переносятся в tokens целыми отрезками (TokenList::appendTokens)
+    size_t total = 0;
+    for (const Chunk& chunk : chunks) {
+        total += chunk.tokens.size();
+    }
+    tokens.reserve(tokens.getTokenCount() + total);
+    int lineCount = 0;
+    auto append = [&](const Token& token) {
+        if (token.type == TokenType::END_LINE) {
+            ++lineCount;
+        }
+        tokens.addToken(token);
+    };
+    const char* position = begin;
+    bool finished = chunks.empty();
+    for (const Chunk& chunk : chunks) {
+        if (finished || position >= chunk.end) {
+            continue; // часть целиком поглощена токеном из предыдущей
+        }
+        long step = findStep(chunk, position);
+        if (step < 0) {
+            // Досчитываем последовательно, пока не попадём на начало шага этой части
+            DfaLexer lexer(position, end);
+            TokenStream tail;
+            tail.setSource(position, end);
+            while (lexer.position() < chunk.end && (step = findStep(chunk, lexer.position())) < 0) {
+                bool more = lexer.next(tail);
+                for (int i = 0; i < tail.size(); ++i) {
+                    append(tail.getToken(i));
+                }
+                tail.clear();
+                if (!more) {
+                    finished = true;
+                    break;
+                }
+            }
+            position = lexer.position();
+            if (step < 0) {
+                continue;
+            }
+        }
+        for (int i = chunk.stepTokens[step]; i < chunk.tokens.size(); ++i) {
+            if (chunk.tokens.getType(i) == TokenType::END_LINE) {
+                ++lineCount;
+            }
+        }
+        tokens.appendTokens(chunk.tokens, chunk.stepTokens[step], chunk.tokens.size(), chunk.tokenSymbols, chunk.symbols, chunk.strings);
+        position = chunk.stop;
+        if (chunk.stop == end) {
+            finished = true;
+        }
+    }
+    return lineCount;
+}
@@ -0,0 +1,31 @@
+﻿#ifndef PARALLELLEXER_H
+#define PARALLELLEXER_H
+
+#include <cstddef>
+#include "TokenList.h"
+
+// Параллельный лексический анализ большого входа. Вход режется по границам строк
+// на части, каждая часть разбирается DfaLexer в своём потоке и там же получает символы
+// в своих таблицах, затем потоки токенов склеиваются по порядку с пересчётом символов.
+// Результат совпадает с последовательным разбором:
+// если токен на стыке частей захватил начало следующей части (например, PROGRAM
+// без пробела перед переводом строки), следующая часть доразбирается с правильной позиции.
+class ParallelLexer {
+public:
+    static const size_t DEFAULT_CHUNK_SIZE = 1 << 20; // меньше 1 МБ на поток не делим
+
+    // threadCount = 0 - по числу ядер
+    explicit ParallelLexer(unsigned threadCount = 0, size_t minChunkSize = DEFAULT_CHUNK_SIZE);
+
+    // Разбирает [begin, end) и добавляет токены в tokens; возвращает число токенов END_LINE.
+    // Исходный текст tokens (TokenList::setSource) должен включать [begin, end)
+    int tokenize(const char* begin, const char* end, TokenList& tokens);
+
+    unsigned getThreadCount() const { return threadCount; }
+
+private:
+    unsigned threadCount;
+    size_t minChunkSize;
+};
+
+#endif // PARALLELLEXER_H
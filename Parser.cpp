@@ -1 +1,359 @@
-#include "Parser.h"
+﻿#include "Parser.h"
+#include "Grammar.h"
+#include "Interner.h"
+#include "StatementSplitter.h"
+#include <cassert>
+#include <deque>
+#include <string>
+
+using namespace Grammar;
+
+namespace {
+
+    constexpr NonTerminal statementSymbols[] = { N_START, N_DESCRIPTIONS, N_OPERATOR, N_CYCLE_STATEMENT, N_END };
+
+    // Узлы дерева, к которым действия грамматики добавляют следующие
+    struct Builder {
+        TreeArena& arena;
+        TreeNode* parent;   // куда добавляется очередной оператор (корень или Operators тела цикла)
+        int level;
+        TreeNode* keywordNode = nullptr;
+        TreeNode* descrNode = nullptr;
+        TreeNode* varNode = nullptr;  // Varlist последней переменной, пока после неё не было запятой
+        TreeNode* opNode = nullptr;
+        TreeNode* exprNode = nullptr;
+        TreeNode* simpleExprNode = nullptr;
+
+        TreeNode* simpleExpr(int nodeLevel) {
+            if (!simpleExprNode) {
+                simpleExprNode = exprNode->addSon(arena, Interner::LABEL_SIMPLE_EXPR, nodeLevel);
+            }
+            return simpleExprNode;
+        }
+
+        void run(Action action, Interner::Symbol word, Terminal terminal) {
+            NodeKind operandType = terminal == T_CONST ? NodeKind::CONST : NodeKind::ID;
+            switch (action) {
+            case A_KEYWORD:
+                keywordNode = parent->addSon(arena, word, level, NodeKind::WORDS_KEY);
+                break;
+            case A_NAME:
+                keywordNode->addSon(arena, word, level + 1, NodeKind::ID);
+                break;
+            case A_DESCR:
+                descrNode = parent->addSon(arena, Interner::LABEL_DESCRIPTIONS, level)->addSon(arena, Interner::LABEL_DESCR, level + 1);
+                descrNode->addSon(arena, Interner::LABEL_TYPE, level + 2)->addSon(arena, word, level + 3, NodeKind::WORDS_KEY);
+                break;
+            case A_VAR:
+                varNode = descrNode->addSon(arena, Interner::LABEL_VARLIST, level + 2);
+                varNode->addSon(arena, word, level + 3, NodeKind::ID);
+                break;
+            case A_SEPARATOR:
+                // Запятая сразу за переменной попадает в её Varlist, отдельная - в свой
+                (varNode ? varNode : descrNode->addSon(arena, Interner::LABEL_VARLIST, level + 2))->addSon(arena, word, level + 3, NodeKind::SEPARATING);
+                varNode = nullptr;
+                break;
+
+            case A_LHS:
+                opNode = parent->addSon(arena, Interner::LABEL_OPERATORS, level)->addSon(arena, Interner::LABEL_OP, level + 1);
+                opNode->addSon(arena, word, level + 2, NodeKind::ID);
+                break;
+            case A_ASSIGN:
+                opNode->addSon(arena, word, level + 2, NodeKind::OPERATION);
+                exprNode = opNode->addSon(arena, Interner::LABEL_EXPR, level + 3);
+                simpleExprNode = nullptr;
+                break;
+            case A_OPEN:
+                exprNode->addSon(arena, word, level + 6, NodeKind::OPENING_BRACKET);
+                break;
+            case A_CLOSE:
+                exprNode->addSon(arena, word, level + 6, NodeKind::CLOSING_BRACKET);
+                break;
+            case A_OPERAND:
+                simpleExpr(level + 5)->addSon(arena, word, level + 6, operandType);
+                break;
+            case A_OPERATION:
+                // После операции сразу создаётся SimpleExpr для следующего операнда
+                exprNode->addSon(arena, word, level + 6, NodeKind::OPERATION);
+                simpleExprNode = exprNode->addSon(arena, Interner::LABEL_SIMPLE_EXPR, level + 5);
+                break;
+
+            case A_FOR:
+                opNode = parent->addSon(arena, Interner::LABEL_OPERATORS, level)->addSon(arena, Interner::LABEL_OP, level + 1);
+                opNode->addSon(arena, word, level + 2, NodeKind::WORDS_KEY);
+                exprNode = opNode->addSon(arena, Interner::LABEL_EXPR, level + 2);
+                simpleExprNode = nullptr;
+                break;
+            case A_HEADER_ASSIGN:
+                simpleExprNode = exprNode->addSon(arena, Interner::LABEL_SIMPLE_EXPR, level + 3);
+                simpleExprNode->addSon(arena, word, level + 4, NodeKind::OPERATION);
+                break;
+            case A_HEADER_OPERATION:
+            case A_BOUND_OPERAND:
+            case A_HEADER_OPERAND:
+                simpleExpr(level + 3)->addSon(arena, word, level + 4, action == A_HEADER_OPERATION ? NodeKind::OPERATION : operandType);
+                break;
+            case A_TO:
+                opNode->addSon(arena, word, level + 2, NodeKind::WORDS_KEY);
+                exprNode = opNode->addSon(arena, Interner::LABEL_EXPR, level + 2);
+                simpleExprNode = nullptr;
+                break;
+            case A_BOUND_OPEN:
+                exprNode->addSon(arena, word, level + 3, NodeKind::OPENING_BRACKET);
+                break;
+            case A_BOUND_CLOSE:
+                exprNode->addSon(arena, word, level + 3, NodeKind::CLOSING_BRACKET);
+                break;
+            case A_BOUND_OPERATION:
+                simpleExprNode = exprNode->addSon(arena, Interner::LABEL_SIMPLE_EXPR, level + 3);
+                simpleExprNode->addSon(arena, word, level + 4, NodeKind::OPERATION);
+                break;
+            case A_DO:
+                // Тело цикла и вложенные циклы строятся на 4 уровня глубже
+                opNode->addSon(arena, word, level + 2, NodeKind::WORDS_KEY);
+                parent = opNode->addSon(arena, Interner::LABEL_NESTED_CYCLE, level + 2)->addSon(arena, Interner::LABEL_OPERATORS, level + 3);
+                level += 4;
+                break;
+
+            case A_NEW_OP:
+                exprNode = parent->addSon(arena, Interner::LABEL_OP, level)->addSon(arena, Interner::LABEL_EXPR, level + 1);
+                break;
+            case A_BODY_OPERAND:
+                simpleExprNode = exprNode->addSon(arena, Interner::LABEL_SIMPLE_EXPR, level + 2);
+                simpleExprNode->addSon(arena, word, level + 3, operandType);
+                break;
+            case A_BODY_OPERATION:
+                simpleExprNode->addSon(arena, word, level + 3, NodeKind::OPERATION);
+                break;
+            case A_SPLIT:
+                break;
+            }
+        }
+    };
+
+    // Вместо узлов дерева - только то, что проверяет SemanticFacts. Действия добавляют узлы
+    // в прямом порядке дерева, поэтому и идентификаторы попадают в facts в этом порядке.
+    struct Checker {
+        SemanticFacts& facts;
+        Interner::Symbol keyword = SemanticFacts::NONE;
+
+        void use(Interner::Symbol word) {
+            if (!Interner::isIgnoredWord(word)) {
+                facts.used.push_back(word);
+            }
+        }
+
+        void run(Action action, Interner::Symbol word, Terminal terminal) {
+            bool operandIsId = terminal != T_CONST;
+            switch (action) {
+            case A_KEYWORD:
+                keyword = word;
+                break;
+            case A_NAME:
+                // Поддеревья PROGRAM и END не проверяются; в них ищется только их идентификатор
+                if (keyword == Interner::WORD_PROGRAM || keyword == Interner::WORD_END) {
+                    Interner::Symbol& id = keyword == Interner::WORD_PROGRAM ? facts.programId : facts.endId;
+                    if (id == SemanticFacts::NONE) {
+                        id = word;
+                    }
+                }
+                else {
+                    use(word);
+                }
+                break;
+            case A_VAR:
+                facts.declared.push_back(word);
+                use(word);
+                break;
+            case A_LHS:
+                use(word);
+                break;
+            case A_OPERAND:
+            case A_BOUND_OPERAND:
+            case A_HEADER_OPERAND:
+            case A_BODY_OPERAND:
+                if (operandIsId) {
+                    use(word);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    };
+
+    // Присваивания тела цикла делятся так же, как при проверке (см. StatementSplitter):
+    // в boundaries - номера слов с begin, перед которыми разбор видит T_NEXT.
+    // Слово FOR среди присваиваний заканчивает тело (в дерево не попадает ни оно, ни слова после него)
+    void splitAssignments(std::vector<Terminal>& terminals, size_t begin, std::vector<size_t>& boundaries) {
+        size_t end = begin;
+        while (terminals[end] != T_EOS && terminals[end] != T_FOR) {
+            ++end;
+        }
+        terminals[end] = T_EOS;
+        StatementSplitter::split(begin, end,
+            [&](size_t i) { return terminals[i] == T_ASSIGN; },
+            [&](size_t first, size_t) {
+                if (first != begin) {
+                    boundaries.push_back(first);
+                }
+                return true;
+            });
+    }
+
+}
+
+template <class Actions>
+void Parser::parse(Actions& actions, const TokenList& tokens, int first, int last, Statement kind) {
+    Words words;
+    Names names;
+    std::deque<std::string> glued; // склеенные слова, которых нет в тексте одним куском
+    collectWords(tokens, first, last, words, names, glued);
+    if (words.empty()) {
+        return;
+    }
+
+    // Последний элемент - T_EOS, поэтому заглядывать на слово вперёд можно без проверки границ
+    std::vector<Terminal> terminals;
+    terminals.reserve(words.size() + 1);
+    for (std::string_view word : words) {
+        terminals.push_back(classify(word));
+    }
+    names.push_back(Interner::intern(std::string_view()));
+    terminals.push_back(T_EOS);
+
+    // T_NEXT в поток слов не вставляется: перед словом boundaries[boundary] разбор сначала
+    // видит его, а затем само слово
+    std::vector<size_t> boundaries;
+    size_t boundary = 0;
+    std::vector<Symbol> stack = { n(statementSymbols[static_cast<int>(kind)]) };
+    Interner::Symbol word = 0; // последнее принятое слово
+    Terminal matched = T_EOS;
+    size_t position = 0;
+    while (!stack.empty()) {
+        Symbol symbol = stack.back();
+        stack.pop_back();
+        Terminal terminal = boundary < boundaries.size() && boundaries[boundary] == position ? T_NEXT : terminals[position];
+        switch (symbol.kind) {
+        case Symbol::TERMINALS:
+            if (!(symbol.terminals & bit(terminal))) {
+                assert(!"statement passed SintaksisAnalyzer checks but does not match the grammar");
+                return;
+            }
+            matched = terminal;
+            if (terminal == T_NEXT) {
+                ++boundary;
+            }
+            else {
+                word = names[position];
+                ++position;
+            }
+            break;
+        case Symbol::ACTION:
+            if (symbol.value == A_SPLIT) {
+                splitAssignments(terminals, position, boundaries);
+            }
+            actions.run(static_cast<Action>(symbol.value), word, matched);
+            break;
+        case Symbol::NONTERMINAL: {
+            uint8_t index = table.predict[symbol.value][terminal];
+            if (index == NO_RULE) {
+                assert(!"statement passed SintaksisAnalyzer checks but does not match the grammar");
+                return;
+            }
+            const Rule& r = rules[index];
+            for (int i = r.length - 1; i >= 0; --i) {
+                stack.push_back(r.rhs[i]);
+            }
+            break;
+        }
+        }
+    }
+}
+
+void Parser::parseProgram(TreeArena& arena, TreeNode* root, const TokenList& tokens, int first, int last, Statement kind, int level) {
+    Builder builder{ arena, root, level };
+    parse(builder, tokens, first, last, kind);
+}
+
+void Parser::checkProgram(SemanticFacts& facts, const TokenList& tokens, int first, int last, Statement kind) {
+    Checker checker{ facts };
+    parse(checker, tokens, first, last, kind);
+}
+
+void Parser::collectWords(const TokenList& tokens, int first, int last, Words& words, Names& names, std::deque<std::string>& glued) {
+    const TokenStream& stream = tokens.getStream();
+    for (int i = first; i < last; ++i) {
+        TokenType type = tokens.getType(i);
+        if (type == TokenType::END_LINE) {
+            continue;
+        }
+        // Лексер добавляет END дважды с одним и тем же смещением
+        if (type == TokenType::END && i > first && tokens.getType(i - 1) == TokenType::END
+            && stream.getOffset(i - 1) == stream.getOffset(i)) {
+            continue;
+        }
+
+        std::string_view lexeme = tokens.getLexeme(i);
+        bool whole = true; // слово - ровно один токен, и его номер в Interner уже есть
+        if (i + 1 < last && gluedToNext(tokens, i)) {
+            whole = false;
+            glued.emplace_back(lexeme);
+            do {
+                glued.back() += tokens.getLexeme(++i);
+            } while (i + 1 < last && gluedToNext(tokens, i));
+            lexeme = glued.back();
+        }
+
+        if (whole && lexeme.find(' ') == std::string_view::npos && (lexeme.size() < 2 || lexeme.back() != ',')) {
+            words.push_back(lexeme);
+            names.push_back(tokens.getName(i));
+            continue;
+        }
+
+        // Части склеенного или разделённого слова вносятся в Interner здесь
+        auto add = [&](std::string_view word) {
+            words.push_back(word);
+            names.push_back(Interner::intern(word));
+        };
+        size_t space;
+        while ((space = lexeme.find(' ')) != std::string_view::npos) {
+            if (space > 0) {
+                add(lexeme.substr(0, space));
+            }
+            lexeme.remove_prefix(space + 1);
+        }
+        if (lexeme.size() > 1 && lexeme.back() == ',') {
+            add(lexeme.substr(0, lexeme.size() - 1));
+            lexeme.remove_prefix(lexeme.size() - 1);
+        }
+        if (!lexeme.empty()) {
+            add(lexeme);
+        }
+    }
+}
+
+bool Parser::gluedToNext(const TokenList& tokens, int i) {
+    // Слова на P и E лексер дочитывает до пробельного символа включительно, и этот символ
+    // не попадает в текст строки: следующий токен сразу за ним оказывается частью того же слова
+    TokenType type = tokens.getType(i);
+    std::string_view lexeme = tokens.getLexeme(i);
+    if ((type != TokenType::ID_NAME && type != TokenType::ERROR) || lexeme.empty()
+        || (lexeme[0] != 'P' && lexeme[0] != 'E') || tokens.getType(i + 1) == TokenType::END_LINE) {
+        return false;
+    }
+    const TokenStream& stream = tokens.getStream();
+    size_t sourceLength = lexeme.size();
+    if (type == TokenType::ERROR && lexeme.find(' ') != std::string_view::npos) {
+        --sourceLength; // "END x" в тексте записано как "ENDx"
+    }
+    const char* end = stream.getToken(i).position + sourceLength;
+    const char* next = stream.getToken(i + 1).position;
+#ifdef _WIN32
+    if (next == end + 2 && end[0] == '\r' && end[1] == '\n') {
+        return true; // "\r\n" читался как один символ
+    }
+#endif
+    return next == end + 1;
+}
+
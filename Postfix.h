@@ -8,6 +8,8 @@
 #include <string>
 #include <algorithm>
 #include <fstream>
+#include "Trace.h"
+#include "StatementSplitter.h"
 
 using namespace std;
 
@@ -28,12 +30,13 @@ public:
         return 0; //    
     }
 
-    //     
-    vector<string> infixToPostfix(const vector<string>& tokens) {
+    //      [first, last)  
+    vector<string> infixToPostfix(vector<string>::const_iterator first, vector<string>::const_iterator last) {
         stack<string> operators;
         vector<string> postfix;
 
-        for (const string& token : tokens) {
+        for (vector<string>::const_iterator it = first; it != last; ++it) {
+            const string& token = *it;
             if (isalnum(token[0])) {
                 postfix.push_back(token);
             }
@@ -64,9 +67,14 @@ public:
             operators.pop();
         }
 
+        TRACE(POSTFIX, 2, "Expression: %u tokens, %u in postfix", last - first, postfix.size());
         return postfix;
     }
 
+    vector<string> infixToPostfix(const vector<string>& tokens) {
+        return infixToPostfix(tokens.begin(), tokens.end());
+    }
+
     //    
     vector<string> tokenize(const string& line) {
         vector<string> tokens;
@@ -108,8 +116,16 @@ public:
 
     //    
     string processExpression(const string& line) {
-        vector<string> tokens = tokenize(line);
-        vector<string> postfix = infixToPostfix(tokens);
+        return processExpression(tokenize(line));
+    }
+
+    //  ,    
+    string processExpression(const vector<string>& tokens) {
+        return processExpression(tokens.begin(), tokens.end());
+    }
+
+    string processExpression(vector<string>::const_iterator first, vector<string>::const_iterator last) {
+        vector<string> postfix = infixToPostfix(first, last);
 
         ostringstream oss;
         for (const string& token : postfix) {
@@ -165,13 +181,19 @@ public:
                 indent = nestedIndent;
             }
             else {
-                string expression;
-                while (i < bodyTokens.size() && bodyTokens[i] != "FOR" && bodyTokens[i] != ";") {
-                    expression += bodyTokens[i] + " ";
-                    ++i;
+                size_t end = i;
+                while (end < bodyTokens.size() && bodyTokens[end] != "FOR" && bodyTokens[end] != ";") {
+                    ++end;
                 }
-                --i;
-                bodyProcessed << processExpression(expression) << " ";
+                //    ,      (. StatementSplitter)
+                StatementSplitter::split(i, end,
+                    [&](size_t j) { return bodyTokens[j] == "="; },
+                    [&](size_t first, size_t last) {
+                        bodyProcessed << processExpression(bodyTokens.begin() + first, bodyTokens.begin() + last);
+                        return true;
+                    });
+                bodyProcessed << " ";
+                i = end - 1;
             }
             ++i;
         }
@@ -179,6 +201,7 @@ public:
         ostringstream oss;
         int m1_index = indent++;
         int m2_index = indent++;
+        TRACE(POSTFIX, 1, "FOR loop: labels m%u, m%u", m1_index, m2_index);
         string m1 = "m" + to_string(m1_index);
         string m2 = "m" + to_string(m2_index);
 
@@ -212,8 +235,10 @@ public:
 
         istringstream iss(input);
         string line;
+        int lineNumber = 0;
 
         while (getline(iss, line)) {
+            TRACE(POSTFIX, 1, "Line %u: %u chars", ++lineNumber, line.size());
             line.erase(0, line.find_first_not_of(" \t"));
             line.erase(line.find_last_not_of(" \t") + 1);
 
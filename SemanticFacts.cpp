@@ -0,0 +1,118 @@
+﻿#include "SemanticFacts.h"
+#include <string>
+#include <unordered_set>
+
+void SemanticFacts::clear() {
+    programId = NONE;
+    endId = NONE;
+    declared.clear();
+    used.clear();
+}
+
+void SemanticFacts::collect(const FlatTree& tree, const TreeIndex& index) {
+    clear();
+    if (tree.empty()) return;
+
+    // Первый Id среди сыновей узлов PROGRAM и END, которые сами сыновья корня
+    for (FlatTree::NodeRef child : tree.root().getChildren()) {
+        Interner::Symbol* id = child.getSymbol() == Interner::WORD_PROGRAM ? &programId
+            : child.getSymbol() == Interner::WORD_END ? &endId : nullptr;
+        if (id == nullptr || *id != NONE) {
+            continue;
+        }
+        for (FlatTree::NodeRef subChild : child.getChildren()) {
+            if (subChild.getKind() == NodeKind::ID) {
+                *id = subChild.getSymbol();
+                break;
+            }
+        }
+    }
+
+    // Поддеревья PROGRAM и END не проверяются: их отрезки [начало, конец) в прямом порядке,
+    // вложенные друг в друга поглощаются внешними
+    std::vector<std::pair<uint32_t, uint32_t>> skipped;
+    TreeIndex::Nodes programs = index.find(Interner::WORD_PROGRAM);
+    TreeIndex::Nodes ends = index.find(Interner::WORD_END);
+    const uint32_t* p = programs.begin();
+    const uint32_t* e = ends.begin();
+    while (p != programs.end() || e != ends.end()) {
+        uint32_t node = e == ends.end() || (p != programs.end() && *p < *e) ? *p++ : *e++;
+        if (skipped.empty() || node >= skipped.back().second) {
+            skipped.push_back({ node, tree[node].end });
+        }
+    }
+    // Узлы запросов идут в прямом порядке, поэтому отрезки просматриваются один раз
+    auto outsideSkipped = [&](std::vector<std::pair<uint32_t, uint32_t>>::const_iterator& range, uint32_t node) {
+        while (range != skipped.end() && range->second <= node) {
+            ++range;
+        }
+        return range == skipped.end() || node < range->first;
+    };
+
+    // Переменные (Id) каждого узла Varlist
+    auto range = skipped.cbegin();
+    for (uint32_t varlist : index.find(Interner::LABEL_VARLIST)) {
+        if (!outsideSkipped(range, varlist)) {
+            continue;
+        }
+        for (FlatTree::NodeRef child : FlatTree::NodeRef(tree, varlist).getChildren()) {
+            if (child.getKind() == NodeKind::ID) {
+                declared.push_back(child.getSymbol());
+            }
+        }
+    }
+
+    range = skipped.cbegin();
+    for (uint32_t node : index.find(NodeKind::ID)) {
+        if (outsideSkipped(range, node) && !Interner::isIgnoredWord(tree[node].symbol)) {
+            used.push_back(tree[node].symbol);
+        }
+    }
+}
+
+bool SemanticFacts::report(std::ostream& out, std::ostream* errors) const {
+    auto line = [&](const std::string& text) {
+        if (errors) *errors << text << std::endl;
+        out << text << std::endl;
+    };
+    bool valid = true;
+
+    // Проверка совпадения идентификаторов PROGRAM и END
+    if (programId == NONE || endId == NONE) {
+        line("Warning: Missing PROGRAM or END identifier.");
+    }
+    else if (programId != endId) {
+        line("Error: PROGRAM identifier \"" + std::string(Interner::text(programId))
+            + "\" does not match END identifier \"" + std::string(Interner::text(endId)) + "\".");
+        valid = false;
+    }
+    else {
+        line("PROGRAM and END identifiers match: \"" + std::string(Interner::text(programId)) + "\".");
+    }
+
+    std::unordered_set<Interner::Symbol> declaredVars;
+    for (Interner::Symbol symbol : declared) {
+        if (!declaredVars.insert(symbol).second) {
+            out << Interner::text(symbol) << " - redeclaring a variable\n";
+        }
+    }
+
+    // Порядок вставки определяет порядок вывода, поэтому used идёт в прямом порядке дерева
+    std::unordered_set<std::string> undeclaredVars;
+    for (Interner::Symbol symbol : used) {
+        if (declaredVars.find(symbol) == declaredVars.end()) {
+            undeclaredVars.insert(std::string(Interner::text(symbol)));
+        }
+    }
+    if (undeclaredVars.empty()) {
+        line("All variables are properly declared.");
+    }
+    else {
+        line("The following variables are used but not declared:");
+        for (const std::string& var : undeclaredVars) {
+            line("  " + var);
+        }
+        valid = false;
+    }
+    return valid;
+}
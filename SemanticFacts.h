@@ -0,0 +1,32 @@
+﻿#ifndef SEMANTICFACTS_H
+#define SEMANTICFACTS_H
+
+#include "FlatTree.h"
+#include "Interner.h"
+#include "TreeIndex.h"
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+// То, что нужно семантической проверке программы: идентификаторы после PROGRAM и END,
+// объявленные переменные (Id в Varlist) и используемые идентификаторы (Id вне поддеревьев
+// PROGRAM и END, кроме служебных слов), каждые в прямом порядке дерева. Собирается либо
+// по индексу готового дерева (collect), либо прямо при разборе без дерева (Parser::checkProgram).
+struct SemanticFacts {
+    static constexpr Interner::Symbol NONE = 0xFFFFFFFFu;
+
+    Interner::Symbol programId = NONE;
+    Interner::Symbol endId = NONE;
+    std::vector<Interner::Symbol> declared;
+    std::vector<Interner::Symbol> used;
+
+    void clear();
+    // index построен по tree; просматриваются только Varlist, Id и поддеревья PROGRAM и END
+    void collect(const FlatTree& tree, const TreeIndex& index);
+
+    // Сообщения проверки в out и, если errors не nullptr, в errors (как в errors.txt);
+    // false, если идентификаторы PROGRAM и END различны или есть необъявленные переменные
+    bool report(std::ostream& out, std::ostream* errors) const;
+};
+
+#endif // SEMANTICFACTS_H
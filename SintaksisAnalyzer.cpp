@@ -1,11 +1,16 @@
 ﻿#include "SintaksisAnalyzer.h"
 #include "TokenList.h"
+#include "Trace.h"
+#include "StatementSplitter.h"
 #include <iostream>
 #include <string>
 #include <cstring> // для memset
 #include <stack>
 
 SintaksisAnalyzer::SintaksisAnalyzer() {
+}
+
+void SintaksisAnalyzer::open_files() {
     outputFile.open("parsing_tree.txt");
     if (!outputFile.is_open()) {
         throw std::ios_base::failure("Failed to open the file.");
@@ -26,10 +31,10 @@ SintaksisAnalyzer::~SintaksisAnalyzer() {
     }
 }
 
-void SintaksisAnalyzer::check_error() {
+void SintaksisAnalyzer::check_error(const int last_line) {
     if (!is_valid_end) {
         clear_tree();
-        error(1234, "", "Отсутствует конец программы(END id_name)");
+        error(last_line, "", "Отсутствует конец программы(END id_name)");
         throw std::ios_base::failure("An error was encountered in the input file.");
     }
 
@@ -40,14 +45,14 @@ void SintaksisAnalyzer::check_error() {
     bool found_operator = false;
 
     // Проверяем порядок лексем
-    for (int i = 0; i < count_types_lexeme; ++i) {
+    for (size_t i = 0; i < types_lexeme.size(); ++i) {
         const std::string& lexeme = types_lexeme[i];
 
         if (lexeme == "start") {
             // Убедимся, что "start" встречается только один раз
             if (found_start) {
                 clear_tree();
-                error(1234, "", "Множественные вхождения start");
+                error(lines_lexeme[i], "", "Множественные вхождения start");
                 throw std::ios_base::failure("An error was encountered in the input file.");
             }
             found_start = true;
@@ -56,7 +61,7 @@ void SintaksisAnalyzer::check_error() {
             // Убедимся, что "end" встречается только один раз
             if (found_end) {
                 clear_tree();
-                error(1234, "", "Множественные вхождения end");
+                error(lines_lexeme[i], "", "Множественные вхождения end");
                 throw std::ios_base::failure("An error was encountered in the input file.");
             }
             found_end = true;
@@ -65,7 +70,7 @@ void SintaksisAnalyzer::check_error() {
             // description должно идти только после start и до оператора или end
             if (!found_start || found_end || found_operator) {
                 clear_tree();
-                error(1234, "", "Ошибка: описание должно идти после start и до оператора или end");
+                error(lines_lexeme[i], "", "Ошибка: описание должно идти после start и до оператора или end");
                 throw std::ios_base::failure("An error was encountered in the input file.");
             }
             found_description = true;
@@ -74,7 +79,7 @@ void SintaksisAnalyzer::check_error() {
             // operator должно идти только после description и до end
             if (!found_start || !found_description || found_end) {
                 clear_tree();
-                error(1234, "", "Ошибка: оператор должен идти после description и до end");
+                error(lines_lexeme[i], "", "Ошибка: оператор должен идти после description и до end");
                 throw std::ios_base::failure("An error was encountered in the input file.");
             }
             found_operator = true;
@@ -82,7 +87,7 @@ void SintaksisAnalyzer::check_error() {
     }
 }
 
-bool SintaksisAnalyzer::isValidOperator_for_cylce(const std::string opLine) {
+bool SintaksisAnalyzer::isValidOperator_for_cylce(const std::string& opLine) {
     std::string currentExpression = "";
     std::vector<std::string> expressions;
     int balance = 0; // Для учета вложенных выражений, если появятся скобки или сложные конструкции
@@ -121,6 +126,9 @@ bool SintaksisAnalyzer::isValidOperator_for_cylce(const std::string opLine) {
 
 
 void SintaksisAnalyzer::clear_tree() {
+    if (check_only) {
+        return; // файлов дерева в этом режиме нет
+    }
     outputFile.close();
     std::ofstream treeFile("parsing_tree.txt", std::ios::trunc);
     if (!treeFile.is_open()) {
@@ -129,7 +137,7 @@ void SintaksisAnalyzer::clear_tree() {
     treeFile.close(); // Закрываем файл после очистки
 }
 
-bool SintaksisAnalyzer::isValidIdentifier(const std::string word) {
+bool SintaksisAnalyzer::isValidIdentifier(std::string_view word) {
     for (char c : word) {
         if (!isalpha(c)) { // Если символ не является буквой
             return false;
@@ -139,50 +147,37 @@ bool SintaksisAnalyzer::isValidIdentifier(const std::string word) {
 }
 
 // Проверка, является ли строка валидным выражением (пока допускаем только числа)
-bool SintaksisAnalyzer::isValidExpression(const std::string expr) {
+bool SintaksisAnalyzer::isValidExpression(std::string_view expr) {
     return !expr.empty() && std::all_of(expr.begin(), expr.end(), ::isdigit);
 }
 
-std::string* SintaksisAnalyzer::split(const std::string line, int& numWords) {
-    static const int MAX_WORDS = 1000;  // Максимальное количество слов
-    static std::string words[MAX_WORDS];  // Статический массив слов
-
-    // Очистка массива перед использованием
-    for (int i = 0; i < MAX_WORDS; i++) {
-        words[i].clear();
-    }
-
+void SintaksisAnalyzer::split(std::string_view line, Words& words) {
+    // Слова - string_view в текст line, память вектора переиспользуется от строки к строке
+    words.clear();
     size_t start = 0;
-    size_t end = line.find(' '); // Находим первый пробел
-    numWords = 0;                // Счётчик слов
-
-    // Разделение строки на слова
-    while (end != std::string::npos && numWords < MAX_WORDS) {
-        std::string word = line.substr(start, end - start);
-        if (!word.empty()) { // Добавляем слово, только если оно не пустое
-            words[numWords++] = word;
+    while (start < line.size()) {
+        size_t end = line.find(' ', start);
+        if (end == std::string_view::npos) {
+            end = line.size();
         }
-        start = end + 1;
-        end = line.find(' ', start); // Находим следующий пробел
-    }
-
-    // Добавляем последнее слово, если оно есть
-    if (start < line.length()) {
-        std::string word = line.substr(start);
-        if (!word.empty() && numWords < MAX_WORDS) {
-            words[numWords++] = word;
+        if (end > start) { // Добавляем слово, только если оно не пустое
+            words.push_back(line.substr(start, end - start));
         }
+        start = end + 1;
     }
+}
 
-    return words;  // Возвращаем указатель на массив слов
+const SintaksisAnalyzer::Words& SintaksisAnalyzer::split(const std::string& line) {
+    split(line, split_words);
+    return split_words;
 }
 
 // Проверка, является ли строка корректным оператором (пока простая проверка)
-bool SintaksisAnalyzer::isValidOperator(const std::string opLine) {
+bool SintaksisAnalyzer::isValidOperator(const std::string& opLine) {
     std::string error_;
-    int count_words = 0;
     // Разделяем строку на токены
-    std::string* tokens = split(opLine, count_words);
+    const Words& tokens = split(opLine);
+    int count_words = static_cast<int>(tokens.size());
     // Проверяем, что строка не пустая и содержит минимум "id = что-то"
     if (count_words < 3) {
         return false;
@@ -246,11 +241,15 @@ bool SintaksisAnalyzer::isValidOperator(const std::string opLine) {
 
 // Проверка, является ли строка корректным оператором (пока простая проверка)
 // Проверка, является ли строка корректным оператором (пока простая проверка)
-bool SintaksisAnalyzer::isValidOperator(const std::string opLine, const int count_line) {
+bool SintaksisAnalyzer::isValidOperator(const std::string& opLine, const int count_line) {
+    const Words& words = split(opLine);
+    return isValidOperator(opLine, words, 0, static_cast<int>(words.size()), count_line);
+}
+
+bool SintaksisAnalyzer::isValidOperator(std::string_view opLine, const Words& words, int first, int last, const int count_line) {
     std::string error_;
-    int count_words = 0;
-    // Разделяем строку на токены
-    std::string* tokens = split(opLine, count_words);
+    const std::string_view* tokens = words.data() + first;
+    int count_words = last - first;
     // Проверяем, что строка не пустая и содержит минимум "id = что-то"
     if (count_words < 3) {
         return false;
@@ -263,8 +262,7 @@ bool SintaksisAnalyzer::isValidOperator(const std::string opLine, const int coun
 
     // Проверяем первый токен как идентификатор
     if (!isValidIdentifier(tokens[0])) {
-        error_ = "Id не соответствует правилам, встречен посторонний символ -> " + tokens[0];
-        is_error_flag = true;
+        error_ = "Id не соответствует правилам, встречен посторонний символ -> " + std::string(tokens[0]);
         error(count_line, opLine, error_);
         return false;
     }
@@ -282,7 +280,6 @@ bool SintaksisAnalyzer::isValidOperator(const std::string opLine, const int coun
             // Проверяем, чтобы закрывающая скобка не была вне пары
             if (openBrackets < 0) {
                 error_ = "Закрывающая скобка ')' без пары.";
-                is_error_flag = true;
                 error(count_line, opLine, error_);
                 return false;
             }
@@ -290,8 +287,7 @@ bool SintaksisAnalyzer::isValidOperator(const std::string opLine, const int coun
         else if (expectingOperand) {
             // Ожидаем операнд: идентификатор или выражение
             if (!isValidExpression(tokens[i]) && !isValidIdentifier(tokens[i])) {
-                error_ = "Ожидается идентификатор или выражение, встречено -> " + tokens[i];
-                is_error_flag = true;
+                error_ = "Ожидается идентификатор или выражение, встречено -> " + std::string(tokens[i]);
                 error(count_line, opLine, error_);
                 return false;
             }
@@ -300,8 +296,7 @@ bool SintaksisAnalyzer::isValidOperator(const std::string opLine, const int coun
         else {
             // Ожидаем оператор: '+' или '-'
             if (tokens[i] != "+" && tokens[i] != "-") {
-                error_ = "Ожидается оператор '+' или '-', встречено -> " + tokens[i];
-                is_error_flag = true;
+                error_ = "Ожидается оператор '+' или '-', встречено -> " + std::string(tokens[i]);
                 error(count_line, opLine, error_);
                 return false;
             }
@@ -312,7 +307,6 @@ bool SintaksisAnalyzer::isValidOperator(const std::string opLine, const int coun
     // Если цикл завершился, но последним токеном был оператор, это ошибка
     if (expectingOperand) {
         error_ = "Строка заканчивается на оператор без операнда.";
-        is_error_flag = true;
         error(count_line, opLine, error_);
         return false;
     }
@@ -320,7 +314,6 @@ bool SintaksisAnalyzer::isValidOperator(const std::string opLine, const int coun
     // Если после завершения цикла остались незакрытые скобки, это ошибка
     if (openBrackets > 0) {
         error_ = "Незакрытая скобка '(' обнаружена.";
-        is_error_flag = true;
         error(count_line, opLine, error_);
         return false;
     }
@@ -330,111 +323,102 @@ bool SintaksisAnalyzer::isValidOperator(const std::string opLine, const int coun
 }
 
 
-void SintaksisAnalyzer::building_tree(const int count_line, const std::string line) {
+void SintaksisAnalyzer::building_tree(const int count_line, const std::string& line, const TokenList& tokens, int first, int last) {
+    flat.clear();
+    index.clear();
     if (is_error_flag) {
         clear_tree();
-        std::cout << "An error has been detected, take a look at the file <errors.txt> to get acquainted." << "\n";
+        if (!check_only) {
+            std::cout << "An error has been detected, take a look at the file <errors.txt> to get acquainted." << "\n";
+        }
         throw std::ios_base::failure("An error was encountered in the input file.");
     }
-    if ( is_cycle(line, count_line) ) {
+    // Строка делится на слова один раз, слова общие для всех проверок ниже
+    split(line, line_words);
+    if ( is_cycle(line, line_words, count_line) ) {
         if (!is_valid_start) {
             clear_tree();
-            error(1234, "", "Отсутствует старт программы(PROGRAM id_name)");
+            error(count_line, "", "Отсутствует старт программы(PROGRAM id_name)");
             throw std::ios_base::failure("An error was encountered in the input file.");
         }
         else if (!is_valid_descriptions) {
             clear_tree();
-            error(1234, "", "Отсутствуют описания переменных(INTEGER VarList)");
+            error(count_line, "", "Отсутствуют описания переменных(INTEGER VarList)");
             throw std::ios_base::failure("An error was encountered in the input file.");
         }
-        types_lexeme[count_types_lexeme] = "operator";
-        count_types_lexeme++;
+        types_lexeme.push_back("operator");
+        lines_lexeme.push_back(count_line);
+        TRACE(PARSER, 1, "Line %u: operator, level %u", count_line, level);
         is_valid_operator = true;
         //draw_cycle(line, "");
 
-        std::istringstream inputStream(line);
-        std::string line_;
-        while (std::getline(inputStream, line_)) {
-            Parser::parseProgram(root, line_, level);
-        }
+        parse_statement(tokens, first, last, Parser::Statement::CYCLE);
     }
-    else if ( is_start_program(line, count_line) ) {
-        types_lexeme[count_types_lexeme] = "start";
-        count_types_lexeme++;
+    else if ( is_start_program(line_words) ) {
+        types_lexeme.push_back("start");
+        lines_lexeme.push_back(count_line);
+        TRACE(PARSER, 1, "Line %u: start, level %u", count_line, level);
         is_valid_start = true;
         //draw_start_program(line);
 
-        std::istringstream inputStream(line);
-        std::string line_;
-        while (std::getline(inputStream, line_)) {
-            Parser::parseProgram(root, line_, level);
-        }
+        parse_statement(tokens, first, last, Parser::Statement::START);
     }
-    else if ( is_end_program(line, count_line) ) {
+    else if ( is_end_program(line_words) ) {
         if (!is_valid_start) {
             clear_tree();
-            error(1234, "", "Отсутствует старт программы(PROGRAM id_name)");
+            error(count_line, "", "Отсутствует старт программы(PROGRAM id_name)");
             throw std::ios_base::failure("An error was encountered in the input file.");
         }
         else if (!is_valid_descriptions) {
             clear_tree();
-            error(1234, "", "Отсутствуют описания переменных(INTEGER VarList)");
+            error(count_line, "", "Отсутствуют описания переменных(INTEGER VarList)");
             throw std::ios_base::failure("An error was encountered in the input file.");
         }
         else if (!is_valid_operator) {
             clear_tree();
-            error(1234, "", "Отсутствуют Operators");
+            error(count_line, "", "Отсутствуют Operators");
             throw std::ios_base::failure("An error was encountered in the input file.");
         }
-        types_lexeme[count_types_lexeme] = "end";
-        count_types_lexeme++;
+        types_lexeme.push_back("end");
+        lines_lexeme.push_back(count_line);
+        TRACE(PARSER, 1, "Line %u: end, level %u", count_line, level);
         is_valid_end = true;
         //draw_end_program(line);
 
-        std::istringstream inputStream(line);
-        std::string line_;
-        while (std::getline(inputStream, line_)) {
-            Parser::parseProgram(root, line_, level);
-        }
+        parse_statement(tokens, first, last, Parser::Statement::END);
     }
-    else if ( is_descriptions(line, count_line) ) {
+    else if ( is_descriptions(line, line_words, count_line) ) {
         if (!is_valid_start) {
             clear_tree();
-            error(1234, "", "Отсутствует старт программы(PROGRAM id_name)");
+            error(count_line, "", "Отсутствует старт программы(PROGRAM id_name)");
             throw std::ios_base::failure("An error was encountered in the input file.");
         }
-        types_lexeme[count_types_lexeme] = "description";
-        count_types_lexeme++;
+        types_lexeme.push_back("description");
+        lines_lexeme.push_back(count_line);
+        TRACE(PARSER, 1, "Line %u: description, level %u", count_line, level);
         is_valid_descriptions = true;
         //draw_descriptions(line);
 
-        std::istringstream inputStream(line);
-        std::string line_;
-        while (std::getline(inputStream, line_)) {
-            Parser::parseProgram(root, line_, level);
-        }
+        parse_statement(tokens, first, last, Parser::Statement::DESCRIPTIONS);
     }
-    else if (isValidOperator(line, count_line)) {
+    else if (isValidOperator(line, line_words, 0, static_cast<int>(line_words.size()), count_line)) {
         if (!is_valid_start) {
             clear_tree();
-            error(1234, "", "Отсутствует старт программы(PROGRAM id_name)");
+            error(count_line, "", "Отсутствует старт программы(PROGRAM id_name)");
             throw std::ios_base::failure("An error was encountered in the input file.");
         }
         else if (!is_valid_descriptions) {
             clear_tree();
-            error(1234, "", "Отсутствуют описания переменных(INTEGER VarList)");
+            error(count_line, "", "Отсутствуют описания переменных(INTEGER VarList)");
             throw std::ios_base::failure("An error was encountered in the input file.");
         }
-        types_lexeme[count_types_lexeme] = "operator";
-        count_types_lexeme++;
+        types_lexeme.push_back("operator");
+        lines_lexeme.push_back(count_line);
+        TRACE(PARSER, 1, "Line %u: operator, level %u", count_line, level);
         is_valid_operator = true;
         //draw_operators(line);
 
-        std::istringstream inputStream("OPERATORS " + line);
-        std::string line_;
-        while (std::getline(inputStream, line_)) {
-            Parser::parseProgram(root, line_, level);
-        }
+        parse_statement(tokens, first, last, Parser::Statement::OPERATOR);
     }
     //else if (is_VarList(line)) {
     //    //std::cout << "TYTYTYTYTYTYTYTY" << "\n";
@@ -442,14 +426,10 @@ void SintaksisAnalyzer::building_tree(const int count_line, const std::string li
     //}
     else {
         if (!is_error_flag && line != "") {
-            int count_words = 0;
-            std::string* splitting_line = split(line, count_words);
-            if (count_words == 1) {
-                is_error_flag = true;
-                error(count_line, splitting_line[0], "Недопускается писать 1 переменную/число");
+            if (line_words.size() == 1) {
+                error(count_line, std::string(line_words[0]), "Недопускается писать 1 переменную/число");
             }
             else {
-                is_error_flag = true;
                 error(count_line, line, "Нераспознанные индентификатор, проверьте его корректность.");
             }
         }
@@ -457,7 +437,13 @@ void SintaksisAnalyzer::building_tree(const int count_line, const std::string li
     
 }
 
-void SintaksisAnalyzer::error(const int count_line, const std::string line, const std::string type_error) {
+void SintaksisAnalyzer::error(const int count_line, std::string_view line, const std::string& type_error) {
+    is_error_flag = true;
+    if (check_only) {
+        std::cout << "Ошибка в строке #" << count_line << " - " << type_error << ": " << line << std::endl;
+        return;
+    }
+
     // Режим добавления
     std::ofstream errorFile("errors.txt", std::ios::app);
 
@@ -472,98 +458,27 @@ void SintaksisAnalyzer::error(const int count_line, const std::string line, cons
     errorFile.close();
 }
 
-std::vector<std::string> SintaksisAnalyzer::splitBySemicolonOrNewline(const std::string& line) {
-    std::vector<std::string> expressions;
-    std::vector<size_t> equal_positions;  // Массив позиций символов '='
-
-    // Находим все позиции символов '=' в строке
-    for (size_t i = 0; i < line.size(); ++i) {
-        if (line[i] == '=') {
-            equal_positions.push_back(i);
-        }
-    }
-
-    // Если в строке только один знак '=', то возвращаем всю строку как одно выражение
-    if (equal_positions.size() == 1) {
-        expressions.push_back(line);
-        return expressions;
-    }
-
-    // Разбиваем строку на выражения по позициям '='
-    size_t start_pos = 0;
-    for (size_t i = 1; i < equal_positions.size(); ++i) {
-        // Строка от предыдущего '=' до текущего '='
-        expressions.push_back(line.substr(start_pos, equal_positions[i] - start_pos - 2));
-        start_pos = equal_positions[i] - 2;  // Новая стартовая позиция после '='
-    }
-
-    // Добавляем последнее выражение (после последнего '=')
-    expressions.push_back(line.substr(start_pos));
-
-    return expressions;
-}
-
-
-
-bool SintaksisAnalyzer::is_cycle(const std::string line, const int count_line) {
-    int count_words = 0;
-    int is_do = -1;
-    int is_to = -1;
-    bool flag = false;
-    std::string* lines = split(line, count_words); // Разбиваем строку на слова
-
-    // Разбираем строку на ключевые слова
-    for (int i = 0; i < count_words; ++i) {
-        if (lines[i] == "TO") {
-            if (is_to == -1) {
-                flag = true;
-                is_to = i;  // Присваиваем значение для TO
-            }
-        }
-        else if (lines[i] == "DO") {
-            if (is_do == -1) {
-                flag = true;
-                is_do = i;  // Присваиваем значение для DO
-            }
-        }
-        else if (lines[i] == "for" || lines[i] == "to" || lines[i] == "do") {
-            is_error_flag = true;
-            error(count_line, line, "Ключевое слово (FOR, TO, DO) нужно писать капсом");
-            return false;
-        }
-    }
-
-    if (flag) {
-        if (count_words < 7) { // Минимальная форма: "FOR i = 1 TO i + 10 DO"
-            is_error_flag = true;
-            error(count_line, line, "Не хватает символов для соответствия правилам лексемы (FOR ID = Expr TO Expr DO Operators)");
-            return false;
-        }
+void SintaksisAnalyzer::parse_statement(const TokenList& tokens, int first, int last, Parser::Statement kind) {
+    if (check_only) {
+        Parser::checkProgram(facts, tokens, first, last, kind);
     }
     else {
-        return false;
-    }
-
-    // Проверяем структуру "FOR ... TO ... DO"
-    if (lines[0] != "FOR" || lines[is_to] != "TO" || lines[is_do] != "DO") {
-        is_error_flag = true;
-        error(count_line, line, "Не хватает ключевого слова FOR/TO/DO");
-        return false;
+        Parser::parseProgram(arena, root, tokens, first, last, kind, level);
     }
+}
 
-    // Проверяем выражение перед TO
-    bool is_equal = false;
-    int start = 0;
-    std::vector<std::string> expressionParts1;
-    for (int i = 1; i < is_to; ++i) {
-        if (lines[i] == "=") is_equal = true;
-        expressionParts1.push_back(lines[i]);
-    }
+// Выражение заголовка цикла - слова [first, last); "id = Expr" проверяется с переменной.
+// line() - текст строки для сообщений, собирается только при ошибке
+template <class LineText>
+bool SintaksisAnalyzer::is_cycle_expression(const Words& lines, int first, int last, const int count_line, LineText line) {
+    const std::string_view* expressionParts = lines.data() + first;
+    size_t count = static_cast<size_t>(std::max(0, last - first));
+    bool is_equal = std::find(expressionParts, expressionParts + count, "=") != expressionParts + count;
+    size_t start = 0;
 
     if (is_equal) {
-        if (!isValidIdentifier(expressionParts1[0])) {
-            is_error_flag = true;
-            error(count_line, line, "Невалидная переменная");
+        if (!isValidIdentifier(expressionParts[0])) {
+            error(count_line, line(), "Невалидная переменная");
         }
         start = 2;
     }
@@ -572,32 +487,29 @@ bool SintaksisAnalyzer::is_cycle(const std::string line, const int count_line) {
     int openBrackets = 0;
     std::string error_;
 
-    for (int i = start; i < expressionParts1.size(); ++i) {
-        const std::string& token = expressionParts1[i];
+    for (size_t i = start; i < count; ++i) {
+        std::string_view token = expressionParts[i];
         if (token == "(") openBrackets++;
         else if (token == ")") {
             openBrackets--;
             if (openBrackets < 0) {
                 error_ = "Закрывающая скобка ')' без пары.";
-                is_error_flag = true;
-                error(count_line, line, error_);
+                error(count_line, line(), error_);
                 return false;
             }
         }
         else if (expectingOperand) {
             if (!isValidExpression(token) && !isValidIdentifier(token)) {
-                error_ = "Ожидается идентификатор или выражение, встречено -> " + token;
-                is_error_flag = true;
-                error(count_line, line, error_);
+                error_ = "Ожидается идентификатор или выражение, встречено -> " + std::string(token);
+                error(count_line, line(), error_);
                 return false;
             }
             expectingOperand = false;
         }
         else {
             if (token != "+" && token != "-") {
-                error_ = "Ожидается оператор '+' или '-', встречено -> " + token;
-                is_error_flag = true;
-                error(count_line, line, error_);
+                error_ = "Ожидается оператор '+' или '-', встречено -> " + std::string(token);
+                error(count_line, line(), error_);
                 return false;
             }
             expectingOperand = true;
@@ -606,113 +518,132 @@ bool SintaksisAnalyzer::is_cycle(const std::string line, const int count_line) {
 
     if (expectingOperand) {
         error_ = "Строка заканчивается на оператор без операнда.";
-        is_error_flag = true;
-        error(count_line, line, error_);
+        error(count_line, line(), error_);
         return false;
     }
 
     if (openBrackets > 0) {
         error_ = "Незакрытая скобка '(' обнаружена.";
-        is_error_flag = true;
-        error(count_line, line, error_);
+        error(count_line, line(), error_);
         return false;
     }
+    return true;
+}
 
-    // Проверяем выражение между TO и DO
-    bool is_equal_ = false;
-    int start_ = 0;
-    std::vector<std::string> expressionParts2;
-    for (int i = is_to + 1; i < is_do; ++i) {
-        if (lines[i] == "=") is_equal_ = true;
-        expressionParts2.push_back(lines[i]);
-    }
-
-    if (is_equal_) {
-        if (!isValidIdentifier(expressionParts2[0])) {
-            is_error_flag = true;
-            error(count_line, line, "Невалидная переменная");
-        }
-        start_ = 2;
-    }
+bool SintaksisAnalyzer::is_cycle(const std::string& line, const int count_line) {
+    Words words; // не split_words: их переписывают проверки операторов тела цикла
+    split(line, words);
+    return is_cycle(line, words, count_line);
+}
 
-    bool expectingOperand_ = true;
-    int openBrackets_ = 0;
-    std::string error__;
+// Заголовок и тело каждого уровня вложенности проверяются так же, как раньше проверялся цикл,
+// начинающийся с его FOR: TO и DO - первые такие слова от FOR до конца строки, а в сообщениях -
+// строка от FOR уровня. Проход по словам один: если тело начинается с FOR, это следующий
+// уровень, и он проверяется дальше по той же строке, а не как отдельная строка заново.
+// starts - стек уровней (номер слова FOR); при ошибке во вложенном цикле каждый охватывающий
+// уровень добавляет своё сообщение, как при прежней рекурсивной проверке.
+bool SintaksisAnalyzer::is_cycle(const std::string& line, const Words& lines, const int count_line) {
+    int count_words = static_cast<int>(lines.size());
+    bool flag = false;
 
-    for (int i = start_; i < expressionParts2.size(); ++i) {
-        const std::string& token = expressionParts2[i];
-        if (token == "(") openBrackets_++;
-        else if (token == ")") {
-            openBrackets_--;
-            if (openBrackets_ < 0) {
-                error__ = "Закрывающая скобка ')' без пары.";
-                is_error_flag = true;
-                error(count_line, line, error__);
-                return false;
-            }
-        }
-        else if (expectingOperand_) {
-            if (!isValidExpression(token) && !isValidIdentifier(token)) {
-                error__ = "Ожидается идентификатор или выражение, встречено -> " + token;
-                is_error_flag = true;
-                error(count_line, line, error__);
-                return false;
-            }
-            expectingOperand_ = false;
+    // Разбираем строку на ключевые слова
+    for (std::string_view word : lines) {
+        if (word == "TO" || word == "DO") {
+            flag = true;
         }
-        else {
-            if (token != "+" && token != "-") {
-                error__ = "Ожидается оператор '+' или '-', встречено -> " + token;
-                is_error_flag = true;
-                error(count_line, line, error__);
-                return false;
-            }
-            expectingOperand_ = true;
+        else if (word == "for" || word == "to" || word == "do") {
+            error(count_line, line, "Ключевое слово (FOR, TO, DO) нужно писать капсом");
+            return false;
         }
     }
-
-    if (expectingOperand_) {
-        error__ = "Строка заканчивается на оператор без операнда.";
-        is_error_flag = true;
-        error(count_line, line, error__);
+    if (!flag) {
         return false;
     }
 
-    if (openBrackets_ > 0) {
-        error__ = "Незакрытая скобка '(' обнаружена.";
-        is_error_flag = true;
-        error(count_line, line, error__);
-        return false;
+    // Первые TO и DO начиная с каждого слова
+    std::vector<int> next_to(count_words + 1, -1);
+    std::vector<int> next_do(count_words + 1, -1);
+    for (int i = count_words - 1; i >= 0; --i) {
+        next_to[i] = lines[i] == "TO" ? i : next_to[i + 1];
+        next_do[i] = lines[i] == "DO" ? i : next_do[i + 1];
     }
 
-    // Проверка оператора после DO
-    std::string operatorLine = "";
-    for (int i = is_do + 1; i < count_words; ++i) {
-        operatorLine += lines[i] + " ";
-    }
-    operatorLine = operatorLine.substr(0, operatorLine.size() - 1); // Убираем лишний пробел
-
-    // Проверка на вложенный цикл
-    while (operatorLine.find("FOR") == 0) {  // Если после DO идет новый цикл
-        bool result = is_cycle(operatorLine, count_line);
-        if (!result) {
-            is_error_flag = true;
-            error(count_line, line, "Ошибка во вложенном цикле после DO");
-            return false;
+    std::vector<int> starts;
+    // Текст уровня: вся строка для внешнего цикла, слова от FOR через пробел для вложенных
+    auto level_line = [&](size_t level) {
+        if (level == 0) {
+            return line;
         }
-        operatorLine = operatorLine.substr(operatorLine.find("DO") + 2);  // Убираем этот цикл и продолжаем
-    }
+        std::string text;
+        for (int i = starts[level]; i < count_words; ++i) {
+            text.append(lines[i]) += ' ';
+        }
+        text.pop_back();
+        return text;
+    };
+    // Ошибка на уровне starts.back(): охватывающие уровни сообщают об ошибке во вложенном цикле
+    auto nested_error = [&]() {
+        for (size_t level = starts.size() - 1; level-- > 0;) {
+            error(count_line, level_line(level), "Ошибка во вложенном цикле после DO");
+        }
+        return false;
+    };
 
-    // Разбиваем строку после DO на отдельные выражения
-    std::vector<std::string> expressions = splitBySemicolonOrNewline(operatorLine);
+    int start = 0;
+    while (true) {
+        starts.push_back(start);
+        int is_to = next_to[start];
+        int is_do = next_do[start];
+        if (is_to == -1 && is_do == -1) {
+            return nested_error(); // вложенный "цикл" без TO и DO - не цикл
+        }
+        if (count_words - start < 7) { // Минимальная форма: "FOR i = 1 TO i + 10 DO"
+            error(count_line, level_line(starts.size() - 1), "Не хватает символов для соответствия правилам лексемы (FOR ID = Expr TO Expr DO Operators)");
+            return nested_error();
+        }
+
+        // Проверяем структуру "FOR ... TO ... DO"
+        if (lines[start] != "FOR" || is_to == -1 || is_do == -1) {
+            error(count_line, level_line(starts.size() - 1), "Не хватает ключевого слова FOR/TO/DO");
+            return nested_error();
+        }
+
+        // Проверяем выражение перед TO и выражение между TO и DO
+        if (!is_cycle_expression(lines, start + 1, is_to, count_line, [&]() { return level_line(starts.size() - 1); })
+            || !is_cycle_expression(lines, is_to + 1, is_do, count_line, [&]() { return level_line(starts.size() - 1); })) {
+            return nested_error();
+        }
+
+        // Проверка на вложенный цикл
+        int body = is_do + 1;
+        if (body < count_words && lines[body].substr(0, 3) == "FOR") {
+            start = body;
+            continue;
+        }
+        break;
+    }
+
+    // Присваивания после DO самого вложенного цикла (см. StatementSplitter) проверяются прямо
+    // по словам строки. Текст присваивания для сообщений - его слова через один пробел, у всех
+    // присваиваний, кроме последнего, с пробелом в конце, как у прежнего деления текста
+    // после DO; буфер text общий для всех присваиваний строки
+    std::string text;
+    bool valid = StatementSplitter::split(next_do[starts.back()] + 1, count_words,
+        [&](size_t i) { return lines[i] == "="; },
+        [&](size_t first, size_t last) {
+            text.clear();
+            for (size_t i = first; i < last; ++i) {
+                text.append(lines[i]) += ' ';
+            }
+            if (!text.empty() && last == static_cast<size_t>(count_words)) {
+                text.pop_back();
+            }
+            return isValidOperator(text, lines, static_cast<int>(first), static_cast<int>(last), count_line);
+        });
 
-    // Проверка каждого выражения
-    for (const std::string& expr : expressions) {
-        if (!isValidOperator(expr, count_line)) {
-            is_error_flag = true;
-            error(count_line, line, "Оператор после DO несоответствует правилам.");
-            return false;
-        }
+    if (!valid) {
+        error(count_line, level_line(starts.size() - 1), "Оператор после DO несоответствует правилам.");
+        return nested_error();
     }
 
     return true; // Строка прошла все проверки
@@ -727,9 +658,12 @@ bool SintaksisAnalyzer::is_cycle(const std::string line, const int count_line) {
 
 
 // Проверяет, соответствует ли строка началу программы (PROGRAM <идентификатор>)
-bool SintaksisAnalyzer::is_start_program(const std::string line, const int count_line) {
-    int count_words = 0;
-    std::string* words = split(line, count_words);
+bool SintaksisAnalyzer::is_start_program(const std::string& line, const int count_line) {
+    return is_start_program(split(line));
+}
+
+bool SintaksisAnalyzer::is_start_program(const Words& words) {
+    int count_words = static_cast<int>(words.size());
 
     // Проверка: строка должна состоять ровно из двух слов
     if (count_words != 2) {
@@ -745,9 +679,12 @@ bool SintaksisAnalyzer::is_start_program(const std::string line, const int count
 }
 
 // Проверяет, соответствует ли строка завершению программы (END PROGRAM <идентификатор>)
-bool SintaksisAnalyzer::is_end_program(const std::string line, const int count_line) {
-    int count_words = 0;
-    std::string* words = split(line, count_words);
+bool SintaksisAnalyzer::is_end_program(const std::string& line, const int count_line) {
+    return is_end_program(split(line));
+}
+
+bool SintaksisAnalyzer::is_end_program(const Words& words) {
+    int count_words = static_cast<int>(words.size());
 
     // Проверка: строка должна состоять ровно из трех слов
     if (count_words != 2) {
@@ -762,16 +699,17 @@ bool SintaksisAnalyzer::is_end_program(const std::string line, const int count_l
     return false;
 }
 
-bool SintaksisAnalyzer::is_descriptions(const std::string line, const int count_line) {
-    int count_words = 0;
-    std::string* words = split(line, count_words);
+bool SintaksisAnalyzer::is_descriptions(const std::string& line, const int count_line) {
+    return is_descriptions(line, split(line), count_line);
+}
+
+bool SintaksisAnalyzer::is_descriptions(const std::string& line, const Words& words, const int count_line) {
+    int count_words = static_cast<int>(words.size());
 
     // Проверка: строка должна начинаться с ключевого слова "INTEGER"
     if (count_words < 2 || words[0] != "INTEGER") {
-        if (words[0] == "INTEGER") {
-            is_error_flag = true;
+        if (count_words == 1 && words[0] == "INTEGER") {
             error(count_line, line, "Нет VarList после INTEGER");
-            is_error_flag = true;
         }
         return false;
     }
@@ -780,8 +718,7 @@ bool SintaksisAnalyzer::is_descriptions(const std::string line, const int count_
     if (count_words == 2) {
         // Проверяем валидность идентификатора или выражения
         if (!isValidIdentifier(words[1]) && !isValidExpression(words[1])) {
-            is_error_flag = true;
-            error(count_line, line, "Недопустимый идентификатор или выражение: " + words[1]);
+            error(count_line, line, "Недопустимый идентификатор или выражение: " + std::string(words[1]));
             return false;
         }
         return true;  // Если проверка прошла, то возвращаем true
@@ -789,22 +726,21 @@ bool SintaksisAnalyzer::is_descriptions(const std::string line, const int count_
 
     // Если строка содержит несколько переменных, проверяем их по очереди
     for (int i = 1; i < count_words; ++i) {
+        std::string_view word = words[i]; // слова строки общие для всех проверок, поэтому меняется копия
         // Если это не последний элемент, проверяем, что после него идет запятая
-        if (i < count_words - 1 && words[i].back() != ',') {
-            is_error_flag = true;
-            error(count_line, line, "Пропущена запятая между элементами: " + words[i]);
+        if (i < count_words - 1 && word.back() != ',') {
+            error(count_line, line, "Пропущена запятая между элементами: " + std::string(word));
             return false;
         }
 
         // Убираем запятую, если она есть в конце слова
-        if (words[i].back() == ',') {
-            words[i].erase(words[i].size() - 1); // Убираем последнюю запятую
+        if (word.back() == ',') {
+            word.remove_suffix(1); // Убираем последнюю запятую
         }
 
         // Проверяем валидность идентификатора или выражения
-        if (!isValidIdentifier(words[i]) && !isValidExpression(words[i])) {
-            is_error_flag = true;
-            error(count_line, line, "Недопустимый идентификатор или выражение: " + words[i]);
+        if (!isValidIdentifier(word) && !isValidExpression(word)) {
+            error(count_line, line, "Недопустимый идентификатор или выражение: " + std::string(word));
             return false;
         }
     }
@@ -5,7 +5,11 @@
 #include "TokenList.h"
 #include "TreeNode.h"
 #include "Parser.h"
+#include "Postfix.h"
+#include "AstSnapshot.h"
+#include "TreeIndex.h"
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -18,26 +22,33 @@ class SintaksisAnalyzer {
 public:
     SintaksisAnalyzer();  // 
     ~SintaksisAnalyzer();
+    void open_files();    //  parsing_tree.txt   errors.txt  
     //SintaksisAnalyzer(TokenList& tokenList); //     TokenList
     //void collectLine();              //      tokenSequence
-    void error(const int count_line, const std::string line, const std::string type_error);                    //     
-    void building_tree(const int count_line, const std::string line);            //     
-    std::string* split(const std::string line, int& numWords);
+    void error(const int count_line, std::string_view line, const std::string& type_error);                    //     
+    void building_tree(const int count_line, const std::string& line, const TokenList& tokens, int first, int last); //     ; tokens [first, last) -  
+    using Words = std::vector<std::string_view>; //    , string_view   
 
-    bool isValidIdentifier(const std::string word); // 
-    bool isValidExpression(const std::string expr); // 
-    bool isValidOperator(const std::string opLine, const int count_line); // 
-    bool isValidOperator(const std::string opLine); // 
-    bool isValidOperator_for_cylce(const std::string opLine); // 
+    bool isValidIdentifier(std::string_view word); // 
+    bool isValidExpression(std::string_view expr); // 
+    bool isValidOperator(const std::string& opLine, const int count_line); // 
+    bool isValidOperator(const std::string& opLine); // 
+    bool isValidOperator_for_cylce(const std::string& opLine); // 
 
-    bool is_cycle(const std::string line, const int count_line); // 
-    bool is_start_program(const std::string line, const int count_line); //  
-    bool is_end_program(const std::string line, const int count_line); // 
-    bool is_descriptions(const std::string line, const int count_line); // 
+    bool is_cycle(const std::string& line, const int count_line); // 
+    bool is_start_program(const std::string& line, const int count_line); //  
+    bool is_end_program(const std::string& line, const int count_line); // 
+    bool is_descriptions(const std::string& line, const int count_line); // 
 
     
     void clear_tree();
-    void check_error();
+    //  :     ,       errors.txt
+    void set_check_only(bool enabled) { check_only = enabled; }
+    //     check_only ( ,  analyzeTree,    );
+    // false,   
+    bool check_semantics() { return facts.report(std::cout, nullptr); }
+    bool has_errors() const { return is_error_flag; } //     (  error)
+    void check_error(const int last_line); // last_line - ,    
 
 
     void trim(std::string& str) {
@@ -58,8 +69,8 @@ public:
         //     
         if (outFile.is_open()) {
             //    
-            int maxLevel = root->getMaxLevel(root);
-            root->printTree(outFile, maxLevel);  // rootNode     
+            const FlatTree& tree = flat_tree();
+            tree.printTree(outFile, tree.getMaxLevel());  // rootNode     
             outFile.close();  //    
         }
         else {
@@ -67,13 +78,32 @@ public:
         }
     }
 
-    void Printing_Specific_Tree(const std::string& Nodename, int indentation = 0) {
+    //     (. AstSnapshot),      
+    void Saving_Tree(const std::string& fileName = "parsing_tree.ast") {
+        if (!AstSnapshot::write(flat_tree(), fileName)) {
+            std::cerr << "   !" << std::endl;
+        }
+    }
+
+    void Printing_Specific_Tree(const std::string& Nodename, int /*indentation*/ = 0) {
         std::ofstream outFile("parsing_tree.txt");
 
         //     
         if (outFile.is_open()) {
             //    
-            root->printSpecificNode(outFile, Nodename, indentation);  // rootNode     
+            //      ;     
+            // ,    ,    ;     
+            const FlatTree& tree = flat_tree();
+            uint32_t printedEnd = 0;
+            Interner::Symbol symbol = Interner::lookup(Nodename);
+            if (symbol != Interner::NOT_FOUND) {
+                for (uint32_t node : tree_index().find(symbol)) {
+                    if (node >= printedEnd) {
+                        tree.printTree(outFile, tree.getMaxLevel(1, node), 1, 0, node);
+                        printedEnd = tree[node].end;
+                    }
+                }
+            }
             outFile.close();  //    
         }
         else {
@@ -81,19 +111,45 @@ public:
         }
     }
 
-    std::vector<std::string> splitBySemicolonOrNewline(const std::string& str);
-
     void analyzeTree() {
-        root->analyzeTree(root);
+        root->analyzeTree(flat_tree(), tree_index());
     }
 
+    //        (postfix.txt)
     void printCollectedStrings() {
-        root->printCollectedStrings(root);
+        std::string text;
+        for (const std::string& str : flat_tree().collectChildStrings()) {
+            text += str + "\n";
+        }
+        postfix.processFile(text);
+    }
+
+    //     ;     
+    const FlatTree& flat_tree() {
+        if (flat.empty()) {
+            flat.build(root);
+        }
+        return flat;
+    }
+
+    //         (. TreeIndex);    
+    const TreeIndex& tree_index() {
+        if (index.empty()) {
+            index.build(flat_tree());
+        }
+        return index;
     }
 
 
 private:
-    TreeNode* root = new TreeNode("Program", 0);
+    TreeArena arena; //  ;    
+    TreeNode* root = arena.create<TreeNode>(Interner::LABEL_PROGRAM, 0);
+    FlatTree flat; // ,   
+    TreeIndex index; //    flat
+    PostfixConverter postfix;
+    bool check_only = false;
+    SemanticFacts facts; //      check_only
+    void parse_statement(const TokenList& tokens, int first, int last, Parser::Statement kind);
     int level = 1;
     std::string join(const std::vector<std::string>& parts, const std::string& delimiter) {
         std::string result;
@@ -104,8 +160,23 @@ private:
         return result;
     }
 
-    std::string types_lexeme[1000];
-    int count_types_lexeme = 0;
+    std::vector<std::string> types_lexeme;
+    std::vector<int> lines_lexeme; // ,      types_lexeme
+    Words split_words; //  split
+    Words line_words;  //   building_tree,     
+    //  line  words (  )
+    static void split(std::string_view line, Words& words);
+    //  line    split_words: ,   line,   
+    //   split,        
+    const Words& split(const std::string& line);
+    //      
+    bool isValidOperator(std::string_view opLine, const Words& words, int first, int last, const int count_line); //  [first, last)
+    bool is_cycle(const std::string& line, const Words& lines, const int count_line);
+    template <class LineText>
+    bool is_cycle_expression(const Words& lines, int first, int last, const int count_line, LineText line);
+    bool is_start_program(const Words& words);
+    bool is_end_program(const Words& words);
+    bool is_descriptions(const std::string& line, const Words& words, const int count_line);
     bool is_valid_start = false;
     bool is_valid_end = false;
     bool is_valid_descriptions = false;
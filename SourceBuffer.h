@@ -0,0 +1,41 @@
+﻿#ifndef SOURCEBUFFER_H
+#define SOURCEBUFFER_H
+
+#include <string>
+#include <cstddef>
+
+// Исходный текст программы одним непрерывным диапазоном [begin, end).
+// Обычный файл отображается в память целиком (mmap / MapViewOfFile),
+// а всё, что отобразить нельзя (каналы, устройства), дочитывается через std::ifstream
+// в собственный буфер.
+class SourceBuffer {
+public:
+    SourceBuffer() {}
+    ~SourceBuffer();
+
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    bool open(const std::string& fileName); // false, если файл не удалось открыть
+    void close();
+
+    const char* begin() const { return data; }
+    const char* end() const { return data + length; }
+    size_t size() const { return length; }
+    bool isMapped() const { return mapped; }
+
+private:
+    bool mapFile(const std::string& fileName);
+    bool readStream(const std::string& fileName);
+
+    const char* data = "";
+    size_t length = 0;
+    bool mapped = false;
+    std::string fallback; // содержимое, прочитанное через поток
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif // SOURCEBUFFER_H
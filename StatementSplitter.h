@@ -0,0 +1,36 @@
+﻿#ifndef STATEMENTSPLITTER_H
+#define STATEMENTSPLITTER_H
+
+#include <cstddef>
+
+// Деление тела цикла на присваивания по словам (токенам) оператора: каждое "=", кроме первого,
+// открывает новое присваивание с идентификатора перед ним ("c = 1 bb = c + 2" -> "c = 1" и
+// "bb = c + 2"). Один проход по словам, подстроки не создаются. Общее для проверки
+// (SintaksisAnalyzer::is_cycle), разбора (Parser) и постфиксной записи (PostfixConverter),
+// поэтому границы у них всегда совпадают.
+class StatementSplitter {
+public:
+    // isAssign(i) - слово i это "="; onStatement(begin, end) получает по порядку отрезки
+    // присваиваний [begin, end) внутри [first, last) (последний - до last, даже пустой).
+    // Если onStatement вернёт false, обход прекращается и split тоже возвращает false.
+    template <class IsAssign, class OnStatement>
+    static bool split(size_t first, size_t last, IsAssign isAssign, OnStatement onStatement) {
+        size_t begin = first;
+        bool seenAssignment = false;
+        for (size_t i = first; i < last; ++i) {
+            if (!isAssign(i)) {
+                continue;
+            }
+            if (seenAssignment && i - 1 > begin) {
+                if (!onStatement(begin, i - 1)) {
+                    return false;
+                }
+                begin = i - 1;
+            }
+            seenAssignment = true;
+        }
+        return onStatement(begin, last);
+    }
+};
+
+#endif // STATEMENTSPLITTER_H
@@ -0,0 +1,103 @@
+﻿#include "StringTable.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    const size_t INITIAL_CAPACITY = 64;
+    const size_t TEXT_BLOCK = 16 * 1024;
+
+    inline uint64_t mix(uint64_t h) {
+        // финальное перемешивание MurmurHash3
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+}
+
+StringTable::StringTable() : slots(INITIAL_CAPACITY, Slot{ 0, EMPTY }), mask(INITIAL_CAPACITY - 1) {}
+
+uint64_t StringTable::hashText(std::string_view text) {
+    // По 8 байт за шаг; длина входит в начальное значение
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ull;
+    uint64_t h = text.size() * multiplier;
+    const char* p = text.data();
+    size_t n = text.size();
+    for (; n >= 8; p += 8, n -= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, 8);
+        h = (h ^ mix(word)) * multiplier;
+    }
+    if (n > 0) {
+        uint64_t word = 0;
+        std::memcpy(&word, p, n);
+        h = (h ^ mix(word)) * multiplier;
+    }
+    return mix(h);
+}
+
+size_t StringTable::findSlot(std::string_view text, uint64_t hash) const {
+    uint32_t shortHash = static_cast<uint32_t>(hash);
+    size_t index = static_cast<size_t>(hash >> 32) & mask;
+    for (;; index = (index + 1) & mask) {
+        const Slot& slot = slots[index];
+        if (slot.id == EMPTY || (slot.hash == shortHash && this->text(slot.id) == text)) {
+            return index;
+        }
+    }
+}
+
+uint32_t StringTable::intern(std::string_view text) {
+    uint64_t hash = hashText(text);
+    size_t index = findSlot(text, hash);
+    if (slots[index].id != EMPTY) {
+        return slots[index].id;
+    }
+
+    uint32_t id = size();
+    slots[index] = Slot{ static_cast<uint32_t>(hash), id };
+    starts.push_back(store(text));
+    lengths.push_back(static_cast<uint32_t>(text.size()));
+    hashes.push_back(hash);
+
+    if (lengths.size() * 4 > slots.size() * 3) {
+        grow();
+    }
+    return id;
+}
+
+uint32_t StringTable::find(std::string_view text) const {
+    return slots[findSlot(text, hashText(text))].id; // у свободной ячейки id == EMPTY == NOT_FOUND
+}
+
+const char* StringTable::store(std::string_view text) {
+    if (textBlocks.empty() || blockSize - blockUsed < text.size()) {
+        // Каждый следующий блок вдвое больше; длинная строка получает блок по размеру
+        blockSize = std::max(textBlocks.empty() ? TEXT_BLOCK : blockSize * 2, text.size());
+        textBlocks.emplace_back(new char[blockSize]);
+        blockUsed = 0;
+    }
+    char* data = textBlocks.back().get() + blockUsed;
+    if (!text.empty()) {
+        std::memcpy(data, text.data(), text.size());
+    }
+    blockUsed += text.size();
+    return data;
+}
+
+void StringTable::grow() {
+    std::vector<Slot> bigger(slots.size() * 2, Slot{ 0, EMPTY });
+    mask = bigger.size() - 1;
+    for (uint32_t id = 0; id < hashes.size(); ++id) {
+        size_t index = static_cast<size_t>(hashes[id] >> 32) & mask;
+        while (bigger[index].id != EMPTY) {
+            index = (index + 1) & mask;
+        }
+        bigger[index] = Slot{ static_cast<uint32_t>(hashes[id]), id };
+    }
+    slots.swap(bigger);
+}
@@ -0,0 +1,55 @@
+﻿#ifndef STRINGTABLE_H
+#define STRINGTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Таблица строк: каждая строка получает плотный номер 0, 1, 2, ... в порядке первого
+// появления и хранится один раз. Открытая адресация с линейным пробированием; число ячеек -
+// степень двойки, таблица удваивается, когда заполнена на 3/4. Текст копируется в блоки,
+// которые не перемещаются: string_view из text() действительны, пока жива таблица.
+// Общая таблица процесса - Interner; у частей ParallelLexer свои, пока они разбираются в потоках.
+class StringTable {
+public:
+    static constexpr uint32_t NOT_FOUND = 0xFFFFFFFFu;
+
+    StringTable();
+    StringTable(const StringTable&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+    StringTable(StringTable&&) = default;
+    StringTable& operator=(StringTable&&) = default;
+
+    uint32_t intern(std::string_view text); // номер строки, при необходимости новый
+    uint32_t find(std::string_view text) const; // NOT_FOUND, если строки нет
+
+    uint32_t size() const { return static_cast<uint32_t>(lengths.size()); }
+    std::string_view text(uint32_t id) const { return std::string_view(starts[id], lengths[id]); }
+
+private:
+    struct Slot {
+        uint32_t hash; // младшие 32 бита хеша: сравниваем строки только при совпадении
+        uint32_t id;   // EMPTY - ячейка свободна
+    };
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    static uint64_t hashText(std::string_view text);
+    size_t findSlot(std::string_view text, uint64_t hash) const;
+    const char* store(std::string_view text);
+    void grow();
+
+    std::vector<Slot> slots;
+    size_t mask;
+
+    std::vector<const char*> starts;
+    std::vector<uint32_t> lengths;
+    std::vector<uint64_t> hashes; // чтобы не пересчитывать при росте таблицы
+
+    std::vector<std::unique_ptr<char[]>> textBlocks; // текст строк подряд
+    size_t blockUsed = 0; // занято в textBlocks.back()
+    size_t blockSize = 0;
+};
+
+#endif // STRINGTABLE_H
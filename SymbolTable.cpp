@@ -0,0 +1,81 @@
+﻿#include "SymbolTable.h"
+
+namespace {
+
+    const size_t INITIAL_CAPACITY = 64;
+
+    inline uint64_t mix(uint64_t h) {
+        // финальное перемешивание MurmurHash3
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDull;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ull;
+        h ^= h >> 33;
+        return h;
+    }
+
+}
+
+SymbolTable::SymbolTable() : slots(INITIAL_CAPACITY, EMPTY), mask(INITIAL_CAPACITY - 1) {}
+
+size_t SymbolTable::hashSymbol(uint32_t name, TokenType type) {
+    return static_cast<size_t>(mix((static_cast<uint64_t>(name) << 8) | static_cast<uint64_t>(type)));
+}
+
+size_t SymbolTable::findSlot(uint32_t name, TokenType type) const {
+    size_t index = hashSymbol(name, type) & mask;
+    size_t probes = 1;
+    for (;; index = (index + 1) & mask, ++probes) {
+        uint32_t id = slots[index];
+        if (id == EMPTY || (names[id] == name && types[id] == type)) {
+            break;
+        }
+    }
+    stats.lookups++;
+    stats.totalProbes += probes;
+    if (probes > stats.maxProbes) {
+        stats.maxProbes = probes;
+    }
+    return index;
+}
+
+int SymbolTable::intern(uint32_t name, TokenType type) {
+    size_t index = findSlot(name, type);
+    if (slots[index] != EMPTY) {
+        return static_cast<int>(slots[index]);
+    }
+
+    uint32_t id = static_cast<uint32_t>(types.size());
+    slots[index] = id;
+    names.push_back(name);
+    types.push_back(type);
+
+    if (types.size() * 4 > slots.size() * 3) {
+        grow();
+    }
+    return static_cast<int>(id);
+}
+
+int SymbolTable::find(uint32_t name, TokenType type) const {
+    size_t index = findSlot(name, type);
+    return slots[index] == EMPTY ? NOT_FOUND : static_cast<int>(slots[index]);
+}
+
+void SymbolTable::grow() {
+    std::vector<uint32_t> bigger(slots.size() * 2, EMPTY);
+    mask = bigger.size() - 1;
+    for (uint32_t id = 0; id < types.size(); ++id) {
+        size_t index = hashSymbol(names[id], types[id]) & mask;
+        while (bigger[index] != EMPTY) {
+            index = (index + 1) & mask;
+        }
+        bigger[index] = id;
+    }
+    slots.swap(bigger);
+}
+
+const SymbolTable::ProbeStats& SymbolTable::getProbeStats() const {
+    stats.symbols = types.size();
+    stats.capacity = slots.size();
+    return stats;
+}
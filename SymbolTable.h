@@ -0,0 +1,56 @@
+﻿#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+#include "Token.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Таблица символов: каждая пара (строка, тип) получает плотный номер 0, 1, 2, ...
+// в порядке первого появления, дальше фазы сравнивают номера, а не строки.
+// Строка - номер в таблице строк (StringTable; у TokenList это Interner), сам текст
+// здесь не хранится и не хешируется. Открытая адресация с линейным пробированием;
+// число ячеек - степень двойки, таблица удваивается, когда заполнена на 3/4.
+class SymbolTable {
+public:
+    static constexpr int NOT_FOUND = -1;
+
+    struct ProbeStats {
+        size_t lookups = 0;     // поисков и вставок
+        size_t totalProbes = 0; // просмотренных ячеек за все поиски
+        size_t maxProbes = 0;   // самый длинный поиск
+        size_t symbols = 0;
+        size_t capacity = 0;    // число ячеек
+
+        double averageProbes() const { return lookups ? double(totalProbes) / lookups : 0.0; }
+        double loadFactor() const { return capacity ? double(symbols) / capacity : 0.0; }
+    };
+
+    SymbolTable();
+
+    int intern(uint32_t name, TokenType type); // номер символа, при необходимости новый
+    int find(uint32_t name, TokenType type) const; // NOT_FOUND, если символа нет
+
+    int size() const { return static_cast<int>(types.size()); }
+    uint32_t getName(int id) const { return names[id]; }
+    TokenType getType(int id) const { return types[id]; }
+
+    const ProbeStats& getProbeStats() const;
+
+private:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFFu;
+
+    static size_t hashSymbol(uint32_t name, TokenType type);
+    size_t findSlot(uint32_t name, TokenType type) const;
+    void grow();
+
+    std::vector<uint32_t> slots; // номер символа или EMPTY
+    size_t mask;
+
+    std::vector<uint32_t> names;
+    std::vector<TokenType> types;
+
+    mutable ProbeStats stats;
+};
+
+#endif // SYMBOLTABLE_H
@@ -0,0 +1,30 @@
+﻿#include "Token.h"
+
+const char* tokenTypeName(TokenType type) {
+    switch (type) {
+    case TokenType::PROGRAM:
+        return "PROGRAM";
+    case TokenType::OP:
+        return "OP";
+    case TokenType::BEGIN:
+        return "BEGIN";
+    case TokenType::END:
+        return "END";
+    case TokenType::DESCRIPTIONS:
+        return "DESCRIPTIONS";
+    case TokenType::TYPE:
+        return "TYPE";
+    case TokenType::ID_NAME:
+        return "ID_NAME";
+    case TokenType::INT_NUM:
+        return "INT_NUM";
+    case TokenType::OPERATOR:
+        return "OPERATOR";
+    case TokenType::DELIMITER:
+        return "DELIMITER";
+    case TokenType::ERROR:
+        return "ERROR";
+    default:
+        return "UNKNOWN";
+    }
+}
@@ -2,9 +2,10 @@
 #define TOKEN_H
 
 #include <string>
+#include <string_view>
 #include <fstream>
 
-enum class TokenType {
+enum class TokenType : unsigned char {
     PROGRAM,        // Program -> Begin Descriptions Operators End
     BEGIN,          // Begin -> PROGRAM Id
     END,            // End -> END Id
@@ -20,15 +21,22 @@ enum class TokenType {
     END_LINE,
 };
 
+//   : lexeme     (   
+//   ,    )     TokenList::addToken.
+// position -       ,    (END_LINE, "END x")
 class Token {
 public:
     TokenType type;
-    std::string lexeme;
+    std::string_view lexeme;
     int index;
-    Token() : type(TokenType::UNKNOWN), lexeme(""), index(-1) {}
+    const char* position;
+    Token() : type(TokenType::UNKNOWN), lexeme(), index(-1), position(nullptr) {}
 
-    Token(TokenType t, const std::string& lex, int idx) : type(t), lexeme(lex), index(idx) {}
+    Token(TokenType t, std::string_view lex, int idx, const char* pos = nullptr)
+        : type(t), lexeme(lex), index(idx), position(pos) {}
 };
 
+const char* tokenTypeName(TokenType type); //  ,    output.txt
+
 
 #endif 
\ No newline at end of file
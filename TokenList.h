@@ -2,24 +2,38 @@
 #define TOKENLIST_H
 
 #include "Token.h"
+#include "TokenStream.h"
+#include "SymbolTable.h"
+#include "StringTable.h"
+#include "Interner.h"
 #include <fstream>
+#include <string_view>
+#include <vector>
 
 class TokenList {
 public:
-    TokenList();
-    ~TokenList();
-    static const int MAX_TOKENS = 10000; //   
-    Token* tokenSequence[MAX_TOKENS]; //     
+    void setSource(const char* begin, const char* end) { stream.setSource(begin, end); } // . TokenStream::setSource
     void addToken(const Token& token);
-    int hashFunction(const std::string& lexeme) const;
+    //  [first, last)  tokens    : localSymbols[i] -  
+    //  i  local,  local -   names.   local  
+    //  ,       
+    void appendTokens(const TokenStream& tokens, int first, int last,
+        const std::vector<int>& localSymbols, const SymbolTable& local, const StringTable& names);
+    void reserve(size_t count);
 
     void printTokens(std::ofstream& outputFile);
+    int getTokenCount() const { return stream.size(); }
+    TokenType getType(int i) const { return stream.getType(i); }
+    std::string_view getLexeme(int i) const { return stream.getLexeme(i); }
+    int getSymbol(int i) const { return symbols[i]; } //   (, )  symbolTable
+    Interner::Symbol getName(int i) const { return symbolTable.getName(symbols[i]); } //     Interner
+    const TokenStream& getStream() const { return stream; }
+    const SymbolTable& getSymbolTable() const { return symbolTable; }
 
 private:
-    static const int HASH_TABLE_SIZE = 1000;
-    Token* hashTable[HASH_TABLE_SIZE];
-
-    int tokenCount; //    
+    SymbolTable symbolTable;
+    TokenStream stream;       //     
+    std::vector<int> symbols; //     
 };
 
 #endif 
\ No newline at end of file
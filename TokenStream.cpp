@@ -0,0 +1,94 @@
+﻿#include "TokenStream.h"
+#include <algorithm>
+#include <stdexcept>
+
+void TokenStream::setSource(const char* begin, const char* end) {
+    if (static_cast<size_t>(end - begin) > UINT32_MAX) {
+        throw std::length_error("TokenStream: source text is larger than 4 GB");
+    }
+    sourceBegin = begin;
+    sourceEnd = end;
+}
+
+void TokenStream::checkExtraFits(size_t length) const {
+    if (length > UINT32_MAX - extraLexemes.size()) {
+        throw std::length_error("TokenStream: lexemes outside the source exceed 4 GB");
+    }
+}
+
+void TokenStream::addToken(const Token& token) {
+    const char* text = token.lexeme.data();
+    bool inSource = sourceBegin != nullptr && text >= sourceBegin && text + token.lexeme.size() <= sourceEnd;
+    const char* start = inSource ? text : token.position;
+    if (sourceBegin == nullptr || start < sourceBegin || start > sourceEnd) {
+        start = nullptr;
+    }
+    if (token.lexeme.size() >= EXTRA_LEXEME) {
+        throw std::length_error("TokenStream: lexeme is larger than 2 GB");
+    }
+    uint32_t length = static_cast<uint32_t>(token.lexeme.size());
+
+    if (token.type == TokenType::END_LINE) {
+        length = 0; // текст постоянный, см. getLexeme
+    }
+    else if (!inSource) {
+        checkExtraFits(token.lexeme.size());
+        extraTokens.push_back(size());
+        extraOffsets.push_back(static_cast<uint32_t>(extraLexemes.size()));
+        extraLexemes.append(text, token.lexeme.size());
+        length |= EXTRA_LEXEME;
+    }
+
+    types.push_back(token.type);
+    // Без известной позиции токен считается стоящим там же, где предыдущий
+    offsets.push_back(start != nullptr ? static_cast<uint32_t>(start - sourceBegin) : (offsets.empty() ? 0 : offsets.back()));
+    lengths.push_back(length);
+}
+
+void TokenStream::append(const TokenStream& other, int first, int last) {
+    uint32_t shift = static_cast<uint32_t>(other.sourceBegin - sourceBegin);
+    int base = size() - first;
+    types.insert(types.end(), other.types.begin() + first, other.types.begin() + last);
+    lengths.insert(lengths.end(), other.lengths.begin() + first, other.lengths.begin() + last);
+    size_t from = offsets.size();
+    offsets.insert(offsets.end(), other.offsets.begin() + first, other.offsets.begin() + last);
+    for (size_t i = from; i < offsets.size(); ++i) {
+        offsets[i] += shift;
+    }
+
+    size_t k = std::lower_bound(other.extraTokens.begin(), other.extraTokens.end(), first) - other.extraTokens.begin();
+    for (; k < other.extraTokens.size() && other.extraTokens[k] < last; ++k) {
+        uint32_t length = other.lengths[other.extraTokens[k]] & ~EXTRA_LEXEME;
+        checkExtraFits(length);
+        extraTokens.push_back(other.extraTokens[k] + base);
+        extraOffsets.push_back(static_cast<uint32_t>(extraLexemes.size()));
+        extraLexemes.append(other.extraLexemes.data() + other.extraOffsets[k], length);
+    }
+}
+
+void TokenStream::reserve(size_t count) {
+    types.reserve(count);
+    offsets.reserve(count);
+    lengths.reserve(count);
+}
+
+void TokenStream::clear() {
+    types.clear();
+    offsets.clear();
+    lengths.clear();
+    extraTokens.clear();
+    extraOffsets.clear();
+    extraLexemes.clear();
+}
+
+std::string_view TokenStream::getLexeme(int i) const {
+    if (types[i] == TokenType::END_LINE) {
+        return "END_LINE";
+    }
+    uint32_t length = lengths[i];
+    if (length & EXTRA_LEXEME) {
+        size_t k = std::lower_bound(extraTokens.begin(), extraTokens.end(), i) - extraTokens.begin();
+        return std::string_view(extraLexemes.data() + extraOffsets[k], length & ~EXTRA_LEXEME);
+    }
+    return std::string_view(sourceBegin + offsets[i], length);
+}
@@ -0,0 +1,53 @@
+﻿#ifndef TOKENSTREAM_H
+#define TOKENSTREAM_H
+
+#include "Token.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Поток токенов в виде отдельных массивов: тип, 32-битное смещение начала токена
+// в исходном тексте и длина лексемы. Лексемы из исходного текста не копируются; в общий
+// буфер extraLexemes попадают только лексемы, которых в тексте нет (например "END x").
+// Лексема END_LINE у всех переводов строк одинакова и не хранится вовсе.
+// Строку и столбец токена по смещению даёт LineIndex. Смещениям хватает 32 бит, пока текст
+// и extraLexemes меньше 4 ГБ, а длинам - пока лексема меньше 2 ГБ; больший вход отвергается
+// исключением std::length_error, а не обрезается молча.
+class TokenStream {
+public:
+    // Диапазон исходного текста; задаётся до первого addToken и должен жить дольше потока
+    void setSource(const char* begin, const char* end);
+
+    void addToken(const Token& token);
+    // Токены [first, last) другого потока разом; его исходный текст должен лежать внутри этого,
+    // смещения пересчитываются от начала этого текста
+    void append(const TokenStream& other, int first, int last);
+    void reserve(size_t count);
+    void clear();
+
+    int size() const { return static_cast<int>(types.size()); }
+    TokenType getType(int i) const { return types[i]; }
+    uint32_t getOffset(int i) const { return offsets[i]; }
+    std::string_view getLexeme(int i) const;
+    Token getToken(int i) const { return Token(types[i], getLexeme(i), -1, sourceBegin + offsets[i]); }
+
+private:
+    static const uint32_t EXTRA_LEXEME = 0x80000000u; // старший бит длины: лексема в extraLexemes
+
+    void checkExtraFits(size_t length) const; // std::length_error, если в extraLexemes нет места ещё для length байт
+
+    std::vector<TokenType> types;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> lengths;
+
+    // Лексемы не из текста: номера токенов по возрастанию и начало лексемы в extraLexemes
+    std::vector<int> extraTokens;
+    std::vector<uint32_t> extraOffsets;
+    std::string extraLexemes;
+
+    const char* sourceBegin = nullptr;
+    const char* sourceEnd = nullptr;
+};
+
+#endif // TOKENSTREAM_H
@@ -0,0 +1,82 @@
+﻿#include "Trace.h"
+
+#if TRACE_ENABLED
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+
+namespace {
+
+    struct Event {
+        const char* format;
+        uint32_t a;
+        uint32_t b;
+        Trace::Stage stage;
+    };
+
+    // Общий для всех потоков (ParallelLexer): место под событие занимается атомарным счётчиком
+    Event events[TRACE_CAPACITY];
+    std::atomic<uint64_t> head{ 0 };
+
+    const char* dumpFileName = nullptr;
+    std::terminate_handler previousTerminate = nullptr;
+
+    const char* stageName(Trace::Stage stage) {
+        switch (stage) {
+        case Trace::Stage::LEXER:
+            return "lexer";
+        case Trace::Stage::PARSER:
+            return "parser";
+        default:
+            return "postfix";
+        }
+    }
+
+    void dumpOnExit() {
+        Trace::dump(dumpFileName);
+    }
+
+    void dumpOnTerminate() {
+        Trace::dump(dumpFileName);
+        previousTerminate ? previousTerminate() : std::abort();
+    }
+
+}
+
+void Trace::record(Stage stage, const char* format, uint32_t a, uint32_t b) {
+    uint64_t slot = head.fetch_add(1, std::memory_order_relaxed);
+    events[slot % TRACE_CAPACITY] = { format, a, b, stage };
+}
+
+void Trace::dump(const std::string& fileName) {
+    std::ofstream out(fileName);
+    uint64_t last = head.load(std::memory_order_relaxed);
+    uint64_t first = last > TRACE_CAPACITY ? last - TRACE_CAPACITY : 0;
+    if (first != 0) {
+        out << "(" << first << " earlier events overwritten)\n";
+    }
+    char text[256];
+    for (uint64_t i = first; i < last; ++i) {
+        const Event& event = events[i % TRACE_CAPACITY];
+        std::snprintf(text, sizeof(text), event.format, event.a, event.b);
+        out << stageName(event.stage) << ": " << text << '\n';
+    }
+}
+
+void Trace::dumpAtExit(const char* fileName) {
+    dumpFileName = fileName;
+    std::atexit(dumpOnExit);
+    previousTerminate = std::set_terminate(dumpOnTerminate);
+}
+
+#else
+
+void Trace::record(Stage, const char*, uint32_t, uint32_t) {}
+
+void Trace::dump(const std::string&) {}
+
+void Trace::dumpAtExit(const char*) {}
+
+#endif
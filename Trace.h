@@ -0,0 +1,59 @@
+﻿#ifndef TRACE_H
+#define TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// Трассировка лексера, синтаксического разбора и перевода в постфиксную запись.
+// Уровни задаются при компиляции (/DTRACE_LEVEL=N или отдельно TRACE_LEXER_LEVEL,
+// TRACE_PARSER_LEVEL, TRACE_POSTFIX_LEVEL): 1 - строки и операторы, 2 - токены и узлы
+// дерева, 3 - каждый символ. Событие уровня выше заданного не порождает кода, по умолчанию
+// уровень 0 и трассировка полностью отсутствует. Включённая трассировка только записывает
+// событие в заранее выделенный кольцевой буфер; форматирование откладывается до dump.
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL 0
+#endif
+#ifndef TRACE_LEXER_LEVEL
+#define TRACE_LEXER_LEVEL TRACE_LEVEL
+#endif
+#ifndef TRACE_PARSER_LEVEL
+#define TRACE_PARSER_LEVEL TRACE_LEVEL
+#endif
+#ifndef TRACE_POSTFIX_LEVEL
+#define TRACE_POSTFIX_LEVEL TRACE_LEVEL
+#endif
+#ifndef TRACE_CAPACITY
+#define TRACE_CAPACITY (1 << 16) // событий в буфере, старые перезаписываются
+#endif
+
+#define TRACE_ENABLED (TRACE_LEXER_LEVEL > 0 || TRACE_PARSER_LEVEL > 0 || TRACE_POSTFIX_LEVEL > 0)
+
+namespace Trace {
+
+    enum class Stage : uint8_t { LEXER, PARSER, POSTFIX };
+
+    constexpr int levelOf(Stage stage) {
+        return stage == Stage::LEXER ? TRACE_LEXER_LEVEL
+            : stage == Stage::PARSER ? TRACE_PARSER_LEVEL
+            : TRACE_POSTFIX_LEVEL;
+    }
+
+    // format - строковый литерал printf с двумя целыми аргументами (%u, %d, %c)
+    void record(Stage stage, const char* format, uint32_t a, uint32_t b);
+
+    // Записывает содержимое буфера в файл, от старых событий к новым
+    void dump(const std::string& fileName);
+
+    // dump при выходе из main и при аварийном завершении (необработанное исключение)
+    void dumpAtExit(const char* fileName);
+
+}
+
+#define TRACE(stage, level, format, a, b) \
+    do { \
+        if constexpr ((level) <= Trace::levelOf(Trace::Stage::stage)) { \
+            Trace::record(Trace::Stage::stage, format, static_cast<uint32_t>(a), static_cast<uint32_t>(b)); \
+        } \
+    } while (0)
+
+#endif // TRACE_H
@@ -0,0 +1,18 @@
+﻿#include "TreeArena.h"
+#include <algorithm>
+
+TreeArena::~TreeArena() {
+    for (Block& block : blocks) {
+        ::operator delete(block.data);
+    }
+}
+
+void* TreeArena::allocateSlow(size_t size, size_t alignment) {
+    // Каждый следующий блок вдвое больше предыдущего; большой объект получает блок по размеру
+    size_t blockSize = blocks.empty() ? FIRST_BLOCK : blocks.back().size * 2;
+    blockSize = std::max(blockSize, size + alignment);
+    blocks.push_back({ static_cast<char*>(::operator new(blockSize)), blockSize });
+    current = blocks.size() - 1;
+    used = 0;
+    return allocate(size, alignment);
+}
@@ -0,0 +1,49 @@
+﻿#ifndef TREEARENA_H
+#define TREEARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Память дерева разбора: узлы выделяются подряд из больших блоков сдвигом указателя,
+// по отдельности ничего не освобождается. Всё дерево освобождается разом вместе с ареной
+// (деструкторы узлов не вызываются, поэтому в арене живут только объекты, которым это не нужно).
+class TreeArena {
+public:
+    TreeArena() {}
+    ~TreeArena();
+
+    TreeArena(const TreeArena&) = delete;
+    TreeArena& operator=(const TreeArena&) = delete;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        size_t offset = (used + alignment - 1) & ~(alignment - 1);
+        if (current < blocks.size() && offset + size <= blocks[current].size) {
+            used = offset + size;
+            return blocks[current].data + offset;
+        }
+        return allocateSlow(size, alignment);
+    }
+
+    template <class T, class... Args>
+    T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    static const size_t FIRST_BLOCK = 64 * 1024;
+
+    void* allocateSlow(size_t size, size_t alignment);
+
+    std::vector<Block> blocks;
+    size_t current = 0; // блок, из которого идёт выделение
+    size_t used = 0;    // занято в blocks[current]
+};
+
+#endif // TREEARENA_H
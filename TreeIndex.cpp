@@ -0,0 +1,82 @@
+﻿#include "TreeIndex.h"
+#include <algorithm>
+
+void TreeIndex::build(const FlatTree& tree) {
+    clear();
+    uint32_t count = tree.size();
+    if (count == 0) {
+        return;
+    }
+
+    // Устойчивая сортировка подсчётом по типу; разложенный по строкам этот порядок даёт
+    // узлы строки, упорядоченные по типу и номеру
+    for (uint32_t i = 0; i < count; ++i) {
+        ++kindStart[static_cast<int>(tree[i].kind) + 1];
+    }
+    for (int kind = 0; kind < KIND_COUNT; ++kind) {
+        kindStart[kind + 1] += kindStart[kind];
+    }
+    kindOrder.resize(count);
+    uint32_t kindNext[KIND_COUNT];
+    std::copy(kindStart, kindStart + KIND_COUNT, kindNext);
+    for (uint32_t i = 0; i < count; ++i) {
+        kindOrder[kindNext[static_cast<int>(tree[i].kind)]++] = i;
+    }
+
+    Interner::Symbol symbolCount = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        symbolCount = std::max(symbolCount, tree[i].symbol + 1);
+    }
+    symbolStart.assign(symbolCount + 1, 0);
+    for (uint32_t i = 0; i < count; ++i) {
+        ++symbolStart[tree[i].symbol + 1];
+    }
+    for (Interner::Symbol symbol = 0; symbol < symbolCount; ++symbol) {
+        symbolStart[symbol + 1] += symbolStart[symbol];
+    }
+    symbolOrder.resize(count);
+    std::vector<uint32_t> symbolNext(symbolStart.begin(), symbolStart.end() - 1);
+    for (uint32_t i = 0; i < count; ++i) {
+        symbolOrder[symbolNext[tree[i].symbol]++] = i;
+    }
+    symbolKindOrder.resize(count);
+    symbolKinds.resize(count);
+    symbolNext.assign(symbolStart.begin(), symbolStart.end() - 1);
+    for (uint32_t node : kindOrder) {
+        uint32_t position = symbolNext[tree[node].symbol]++;
+        symbolKindOrder[position] = node;
+        symbolKinds[position] = tree[node].kind;
+    }
+}
+
+void TreeIndex::clear() {
+    kindOrder.clear();
+    std::fill(kindStart, kindStart + KIND_COUNT + 1, 0);
+    symbolStart.clear();
+    symbolOrder.clear();
+    symbolKindOrder.clear();
+    symbolKinds.clear();
+}
+
+TreeIndex::Nodes TreeIndex::find(Interner::Symbol symbol) const {
+    if (symbol + 1 >= symbolStart.size()) {
+        return Nodes(nullptr, nullptr); // строка появилась в таблице уже после построения индекса
+    }
+    return Nodes(symbolOrder.data() + symbolStart[symbol], symbolOrder.data() + symbolStart[symbol + 1]);
+}
+
+TreeIndex::Nodes TreeIndex::find(Interner::Symbol symbol, NodeKind kind) const {
+    if (symbol + 1 >= symbolStart.size()) {
+        return Nodes(nullptr, nullptr);
+    }
+    auto first = symbolKinds.begin() + symbolStart[symbol];
+    auto last = symbolKinds.begin() + symbolStart[symbol + 1];
+    auto range = std::equal_range(first, last, kind);
+    return Nodes(symbolKindOrder.data() + (range.first - symbolKinds.begin()),
+        symbolKindOrder.data() + (range.second - symbolKinds.begin()));
+}
+
+TreeIndex::Nodes TreeIndex::find(NodeKind kind) const {
+    int k = static_cast<int>(kind);
+    return Nodes(kindOrder.data() + kindStart[k], kindOrder.data() + kindStart[k + 1]);
+}
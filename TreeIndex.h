@@ -0,0 +1,56 @@
+﻿#ifndef TREEINDEX_H
+#define TREEINDEX_H
+
+#include "FlatTree.h"
+#include "Interner.h"
+#include "NodeKind.h"
+#include <cstdint>
+#include <vector>
+
+// Вторичный индекс плоского дерева: номера узлов FlatTree по строке (символу Interner)
+// и по типу узла. Строится за один проход подсчётом, после чего любой запрос - это
+// отрезок готового массива, и время запроса пропорционально числу найденных узлов
+// (запрос по строке и типу вместе ещё ищет свой отрезок двоичным поиском по типам).
+class TreeIndex {
+public:
+    // Найденные узлы: номера в FlatTree
+    class Nodes {
+    public:
+        Nodes(const uint32_t* first, const uint32_t* last) : first(first), last(last) {}
+        const uint32_t* begin() const { return first; }
+        const uint32_t* end() const { return last; }
+        uint32_t size() const { return static_cast<uint32_t>(last - first); }
+        bool empty() const { return first == last; }
+        uint32_t operator[](uint32_t i) const { return first[i]; }
+    private:
+        const uint32_t* first;
+        const uint32_t* last;
+    };
+
+    TreeIndex() {}
+    explicit TreeIndex(const FlatTree& tree) { build(tree); }
+
+    void build(const FlatTree& tree);
+    void clear();
+    bool empty() const { return kindOrder.empty(); }
+
+    // Все узлы со строкой symbol ("Descr", "FOR", имя переменной) в прямом порядке
+    Nodes find(Interner::Symbol symbol) const;
+    // Узлы со строкой symbol и типом kind, в прямом порядке: например все вхождения
+    // идентификатора x - find(Interner::lookup("x"), NodeKind::ID)
+    Nodes find(Interner::Symbol symbol, NodeKind kind) const;
+    // Все узлы типа kind в прямом порядке
+    Nodes find(NodeKind kind) const;
+
+private:
+    static constexpr int KIND_COUNT = static_cast<int>(NodeKind::CLOSING_BRACKET) + 1;
+
+    std::vector<uint32_t> kindOrder;       // номера узлов по типу, внутри типа в прямом порядке
+    uint32_t kindStart[KIND_COUNT + 1] = {};
+    std::vector<uint32_t> symbolStart;     // начала отрезков строк, на один больше символов
+    std::vector<uint32_t> symbolOrder;     // номера узлов по строке, внутри строки в прямом порядке
+    std::vector<uint32_t> symbolKindOrder; // то же, но внутри строки по типу, а при равном типе в прямом порядке
+    std::vector<NodeKind> symbolKinds;     // типы узлов symbolKindOrder
+};
+
+#endif // TREEINDEX_H